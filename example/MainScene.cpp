@@ -17,14 +17,15 @@
 void MainScene::CreateScene() {
     FrameRateLimit(60);
 
-    static_cast<zephyr::rendering::SkyboxShader*>(Rendering().Shader("Skybox"))->SkyboxCubemap(
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/right.png"),
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/left.png"),
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/top.png"),
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/bottom.png"),
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/back.png"),
-        zephyr::ZephyrEngine::Instance().Resources().LoadImage("skyboxes/basic_blue/front.png")
-    );
+    const auto skybox = zephyr::ZephyrEngine::Instance().Resources().LoadImages({
+        "skyboxes/basic_blue/right.png",
+        "skyboxes/basic_blue/left.png",
+        "skyboxes/basic_blue/top.png",
+        "skyboxes/basic_blue/bottom.png",
+        "skyboxes/basic_blue/back.png",
+        "skyboxes/basic_blue/front.png"
+    });
+    static_cast<zephyr::rendering::SkyboxShader*>(Rendering().Shader("Skybox"))->SkyboxCubemap(*skybox[0], *skybox[1], *skybox[2], *skybox[3], *skybox[4], *skybox[5]);
 
     auto light = CreateObject("Light"); {
         auto dir_light = light->CreateComponent<zephyr::cbs::DirectionalLight>(glm::vec3(0.05f),
@@ -48,6 +48,9 @@ void zephyr::Scene::Destroy() {
     m_DrawManager.Destroy();
     m_ObjectManager.DestroyObjects();
     m_PhysicsManager.ExitPhysics();
+
+    // Resources released by the scene can be evicted now
+    ZephyrEngine::Instance().Resources().Trim();
 }
 
 void zephyr::Scene::Exit() {
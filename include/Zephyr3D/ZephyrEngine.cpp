@@ -1,5 +1,6 @@
 #include "ZephyrEngine.h"
 #include "Scene.h"
+#include "rendering/GeometryArena.h"
 
 int zephyr::ZephyrEngine::Init() {
     // Initialize OpenGL
@@ -35,6 +36,9 @@ int zephyr::ZephyrEngine::Init() {
 }
 
 void zephyr::ZephyrEngine::Destroy() {
+    // Cached meshes outliving the context only drop their pool ranges
+    rendering::GeometryArena::Instance().Release();
+
     glfwSetWindowShouldClose(m_WindowManager, true);
     glfwTerminate();
 }
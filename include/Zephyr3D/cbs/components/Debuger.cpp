@@ -3,6 +3,8 @@
 #include "../../Scene.h"
 #include "../../ZephyrEngine.h"
 
+#include <cstdio>
+
 zephyr::cbs::Debuger::Debuger(class Object& object, ID_t id)
     : Component(object, id) { }
 
@@ -18,5 +20,39 @@ void zephyr::cbs::Debuger::Update() {
         CONFIGURATION
         "\nfps: " + fps;
 
+    if (m_RenderStats) {
+        const auto& stats = Object().Scene().Rendering().Statistics();
+
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+            "\ndraw calls: %zu (%zu instanced, %zu instances)"
+            "\nmulti draws: %zu (%zu draws)"
+            "\ntriangles: %zu, vertices: %zu"
+            "\nobjects: %zu drawn, %zu culled"
+            "\nprogram switches: %zu, texture binds: %zu"
+            "\nstate changes: %zu (%zu elided)"
+            "\nuploaded: %.1f KB"
+            "\npasses: %zu executed, %zu skipped",
+            stats.DrawCalls, stats.InstancedDrawCalls, stats.Instances,
+            stats.MultiDrawCalls, stats.IndirectDraws,
+            stats.Triangles, stats.Vertices,
+            stats.DrawnObjects, stats.CulledObjects,
+            stats.ProgramSwitches, stats.TextureBinds,
+            stats.StateChanges, stats.ElidedStateChanges,
+            stats.UploadedBytes / 1024.0f,
+            stats.ExecutedPasses, stats.SkippedPasses);
+        msg += buffer;
+
+        // CPU time is spent recording the pass, GPU time executing it
+        for (const auto& pass : Object().Scene().Rendering().PassTimings()) {
+            if (pass.GPU >= 0.0f) {
+                std::snprintf(buffer, sizeof(buffer), "\n%s: cpu %.2f ms, gpu %.2f ms", pass.Name.c_str(), pass.CPU, pass.GPU);
+            } else {
+                std::snprintf(buffer, sizeof(buffer), "\n%s: cpu %.2f ms, gpu n/a", pass.Name.c_str(), pass.CPU);
+            }
+            msg += buffer;
+        }
+    }
+
     DebugInfo.Send(msg);
 }
@@ -13,7 +13,13 @@ public:
     void Initialize() override;
     void Update() override;
 
+    void RenderStats(bool enabled) { m_RenderStats = enabled; }
+    bool RenderStats() const { return m_RenderStats; }
+
     MessageOut<std::string> DebugInfo{ this };
+
+private:
+    bool m_RenderStats{ true };
 };
 
 }
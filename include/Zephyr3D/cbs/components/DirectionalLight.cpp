@@ -14,12 +14,18 @@ zephyr::cbs::DirectionalLight::DirectionalLight(class Object& object, ID_t id, g
 void zephyr::cbs::DirectionalLight::Initialize() {
     if (m_DirectionalLight) {
         m_DirectionalLight->Direction = (*TransformIn).Front();
+        static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
     }
 }
 
 void zephyr::cbs::DirectionalLight::Update() {
     if (m_DirectionalLight) {
-        m_DirectionalLight->Direction = (*TransformIn).Front();
+        const glm::vec3 direction = (*TransformIn).Front();
+
+        if (direction != m_DirectionalLight->Direction) {
+            m_DirectionalLight->Direction = direction;
+            static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
+        }
     }
 }
 
@@ -2,11 +2,31 @@
 #include "Transform.h"
 #include "../Object.h"
 #include "../../Scene.h"
+#include "../../ZephyrEngine.h"
 
+namespace {
 
-zephyr::cbs::MeshRenderer::MeshRenderer(class Object& object, ID_t id, const aiScene& raw_model, const std::string& path)
+zephyr::rendering::Phong::StaticModel::ImportSettings ModelSettings(bool is_static) {
+    zephyr::rendering::Phong::StaticModel::ImportSettings settings;
+    settings.Static = is_static;
+
+    return settings;
+}
+
+}
+
+zephyr::cbs::MeshRenderer::MeshRenderer(class Object& object, ID_t id, const std::string& model_path, bool is_static)
+    : Component(object, id)
+    , m_Model(ZephyrEngine::Instance().Resources().LoadStaticModel(model_path, ModelSettings(is_static)))
+    , m_Static(is_static) {
+
+    m_Model.UserPointer(static_cast<IRenderListener*>(this));
+}
+
+zephyr::cbs::MeshRenderer::MeshRenderer(class Object& object, ID_t id, const aiScene& raw_model, const std::string& path, bool is_static)
     : Component(object, id)
-    , m_Model(raw_model, path) {
+    , m_Model(ZephyrEngine::Instance().Resources().LoadStaticModel(raw_model, path, ModelSettings(is_static)))
+    , m_Static(is_static) {
 
     m_Model.UserPointer(static_cast<IRenderListener*>(this));
 }
@@ -14,11 +34,22 @@ zephyr::cbs::MeshRenderer::MeshRenderer(class Object& object, ID_t id, const aiS
 void zephyr::cbs::MeshRenderer::Initialize() {
     assert(TransformIn.Connected());
 
-    static_cast<zephyr::rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->Register(&m_Model);
+    auto phong = static_cast<zephyr::rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"));
+    if (m_Static) {
+        m_Model.ModelMatrix(TransformIn.Value()->Model());
+        phong->RegisterStatic(&m_Model);
+    } else {
+        phong->Register(&m_Model);
+    }
 }
 
 void zephyr::cbs::MeshRenderer::Destroy() {
-    static_cast<zephyr::rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->Unregister(&m_Model);
+    auto phong = static_cast<zephyr::rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"));
+    if (m_Static) {
+        phong->UnregisterStatic(&m_Model);
+    } else {
+        phong->Unregister(&m_Model);
+    }
 }
 
 zephyr::rendering::IDrawable* zephyr::cbs::MeshRenderer::DrawableHandle() {
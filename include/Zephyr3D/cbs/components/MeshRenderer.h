@@ -13,7 +13,10 @@ class Transform;
 
 class MeshRenderer : public Component, public zephyr::rendering::IRenderListener {
 public:
-    MeshRenderer(class Object& object, ID_t id, const aiScene& raw_model, const std::string& path);
+    // Static renderers are merged with other static geometry once initialized,
+    // later changes of the transform aren't followed
+    MeshRenderer(class Object& object, ID_t id, const std::string& model_path, bool is_static = false);
+    MeshRenderer(class Object& object, ID_t id, const aiScene& raw_model, const std::string& path, bool is_static = false);
 
     void Initialize() override;
     void Destroy() override;
@@ -21,11 +24,20 @@ public:
     zephyr::rendering::IDrawable* DrawableHandle() override;
     void OnDrawObject() override;
 
+    void Material(const rendering::Phong::StaticModel::Material& material) { m_Model.MaterialOverride(material); }
+    const rendering::Phong::StaticModel::Material& Material() const { return m_Model.MaterialOverride(); }
+
+    void Occluder(bool occluder) { m_Model.Occluder(occluder); }
+    bool Occluder() const { return m_Model.Occluder(); }
+
+    bool Static() const { return m_Static; }
+
     PropertyIn<Transform*> TransformIn{ this };
 
 private:
     rendering::Phong::StaticModel m_Model;
     std::string m_ShaderName;
+    bool m_Static;
 };
 
 }
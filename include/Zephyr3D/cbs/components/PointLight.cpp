@@ -20,6 +20,7 @@ zephyr::cbs::PointLight::PointLight(class Object& object, ID_t id, float constan
 void zephyr::cbs::PointLight::Initialize() {
     if (m_PointLight) {
         m_PointLight->Position = (*TransformIn).GlobalPosition();
+        static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
     }
 
     RegisterUpdateCall();
@@ -27,7 +28,12 @@ void zephyr::cbs::PointLight::Initialize() {
 
 void zephyr::cbs::PointLight::Update() {
     if (m_PointLight) {
-        m_PointLight->Position = (*TransformIn).GlobalPosition();
+        const glm::vec3 position = (*TransformIn).GlobalPosition();
+
+        if (position != m_PointLight->Position) {
+            m_PointLight->Position = position;
+            static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
+        }
     }
 }
 
@@ -23,13 +23,20 @@ void zephyr::cbs::SpotLight::Initialize() {
     if (m_SpotLight) {
         m_SpotLight->Position = (*TransformIn).GlobalPosition();
         m_SpotLight->Direction = (*TransformIn).Front();
+        static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
     }
 }
 
 void zephyr::cbs::SpotLight::Update() {
     if (m_SpotLight) {
-        m_SpotLight->Position = (*TransformIn).GlobalPosition();
-        m_SpotLight->Direction = (*TransformIn).Front();
+        const glm::vec3 position = (*TransformIn).GlobalPosition();
+        const glm::vec3 direction = (*TransformIn).Front();
+
+        if (position != m_SpotLight->Position || direction != m_SpotLight->Direction) {
+            m_SpotLight->Position = position;
+            m_SpotLight->Direction = direction;
+            static_cast<rendering::Phong*>(Object().Scene().Rendering().Shader("Phong"))->LightsChanged();
+        }
     }
 }
 
@@ -3,25 +3,13 @@
 #include "../../Scene.h"
 #include "../../ZephyrEngine.h"
 
-unsigned int zephyr::cbs::TextRenderer::s_Index = 1;
+#include <cfloat>
 
 zephyr::cbs::TextRenderer::TextRenderer(class Object& object, ID_t id, EAlign horizontal, EAlign vertical, float size, const std::string& font_path)
     : Component(object, id)
     , m_Horizontal(horizontal)
-    , m_Vertical(vertical) {
-
-    ImGuiIO& io = ImGui::GetIO();
-
-    if (font_path.empty()) {
-        // TODO deafult font with resize
-        m_Font = io.Fonts->Fonts[0];
-    } else {
-        m_Font = io.Fonts->AddFontFromFileTTF(font_path.c_str(), size);
-        io.Fonts->Build();
-    }
-
-    m_Title.append(std::to_string(s_Index));
-    s_Index++;
+    , m_Vertical(vertical)
+    , m_Font(object.Scene().Rendering().Font(font_path, size)) {
 }
 
 void zephyr::cbs::TextRenderer::Initialize() {
@@ -33,33 +21,52 @@ void zephyr::cbs::TextRenderer::Destroy() {
 }
 
 void zephyr::cbs::TextRenderer::Draw() const {
-    ImGui::Begin(m_Title.c_str(), nullptr, ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_AlwaysAutoResize);
-    ImGui::PushFont(m_Font);
-
-    const glm::vec2 margin = ImGui::GetWindowContentRegionMin();       // Might not be correct
-    const glm::vec2 text_size = ImGui::CalcTextSize(m_Text.c_str());
-
-    glm::vec2 pos(0.0f, 0.0f);
-    pos.x = pos.x + m_Offset.x * ZephyrEngine::Instance().Window().Width();
-    pos.y = pos.y + m_Offset.y * ZephyrEngine::Instance().Window().Height();
-    IGUIWidget::Align(&pos.x, -margin.x / 2, ZephyrEngine::Instance().Window().Width() - margin.x / 2 - text_size.x, m_Horizontal);
-    IGUIWidget::Align(&pos.y, -margin.y / 2, ZephyrEngine::Instance().Window().Height() - margin.y / 2 - text_size.y, m_Vertical);
+    if (m_Text.empty()) {
+        return;
+    }
 
-    ImGui::SetWindowPos(pos);
-    ImGui::TextColored(m_Color, m_Text.c_str());
+    // Font size is known once the atlas containing it is built
+    const glm::vec2 window_size(ZephyrEngine::Instance().Window().Width(), ZephyrEngine::Instance().Window().Height());
+    if (m_LayoutDirty || window_size != m_LayoutWindow || m_Font->FontSize != m_LayoutFontSize) {
+        Layout(window_size);
+    }
 
-    ImGui::PopFont();
-    ImGui::End();
+    ImGui::GetForegroundDrawList()->AddText(m_Font, m_Font->FontSize, m_Position, m_PackedColor, m_Text.data(), m_Text.data() + m_Text.size());
 }
 
 void zephyr::cbs::TextRenderer::Font(const std::string& path, float size) {
-    ImGuiIO& io = ImGui::GetIO();
-    m_Font = io.Fonts->AddFontFromFileTTF(path.c_str(), size);
-    io.Fonts->Build();
+    m_Font = Object().Scene().Rendering().Font(path, size);
+    m_LayoutDirty = true;
 }
 
 void zephyr::cbs::TextRenderer::LocalPosition(glm::vec2 offset, EAlign horizontal, EAlign vertical) {
     m_Offset = offset;
     m_Vertical = vertical;
     m_Horizontal = horizontal;
+    m_LayoutDirty = true;
+}
+
+void zephyr::cbs::TextRenderer::Text(std::string text) {
+    if (text != m_Text) {
+        m_Text = std::move(text);
+        m_LayoutDirty = true;
+    }
+}
+
+void zephyr::cbs::TextRenderer::Color(glm::vec4 color) {
+    m_Color = color;
+    m_PackedColor = ImGui::ColorConvertFloat4ToU32(m_Color);
+}
+
+void zephyr::cbs::TextRenderer::Layout(const glm::vec2& window_size) const {
+    const glm::vec2 padding = ImGui::GetStyle().WindowPadding;
+    const glm::vec2 text_size = m_Font->CalcTextSizeA(m_Font->FontSize, FLT_MAX, 0.0f, m_Text.data(), m_Text.data() + m_Text.size());
+
+    IGUIWidget::Align(&m_Position.x, padding.x, window_size.x - padding.x - text_size.x, m_Horizontal);
+    IGUIWidget::Align(&m_Position.y, padding.y, window_size.y - padding.y - text_size.y, m_Vertical);
+    m_Position += m_Offset * window_size;
+
+    m_LayoutWindow = window_size;
+    m_LayoutFontSize = m_Font->FontSize;
+    m_LayoutDirty = false;
 }
@@ -10,8 +10,6 @@
 
 namespace zephyr::cbs {
 
-constexpr char* TITLE_PREFIX = "__dummy";
-
 class TextRenderer : public Component, public rendering::IGUIWidget {
 public:
     TextRenderer(class Object& object, ID_t id, EAlign horizontal, EAlign vertical, float size, const std::string& font_path = "");
@@ -19,32 +17,39 @@ public:
     void Initialize() override;
     void Destroy() override;
 
+    // Text of every renderer goes to one shared draw list, it's laid out again only after a change
     void Draw() const override;
 
     void Font(const std::string& path, float size);
     void LocalPosition(glm::vec2 offset, EAlign horizontal, EAlign vertical);
 
     const std::string Text() const { return m_Text; }
-    void Text(std::string text) { m_Text = text; }
+    void Text(std::string text);
 
     const glm::vec4 Color() const { return m_Color; }
-    void Color(glm::vec4 color) { m_Color = color; }
+    void Color(glm::vec4 color);
 
 public:
     MessageIn<std::string, TextRenderer, &TextRenderer::Text> TextIn{ this };
     MessageIn<glm::vec4, TextRenderer, &TextRenderer::Color> ColorIn{ this };
 
 private:
-    static unsigned int s_Index;
+    void Layout(const glm::vec2& window_size) const;
 
-    std::string m_Title { TITLE_PREFIX };
     std::string m_Text;
 
     EAlign m_Horizontal;
     EAlign m_Vertical;
     glm::vec2 m_Offset{ 0.0f };
     glm::vec4 m_Color{ 1.0f };
+    ImU32 m_PackedColor{ IM_COL32_WHITE };
     ImFont* m_Font;
+
+    // Screen position of the text for the window size and font size it was computed with
+    mutable glm::vec2 m_Position{ 0.0f };
+    mutable glm::vec2 m_LayoutWindow{ 0.0f };
+    mutable float m_LayoutFontSize{ 0.0f };
+    mutable bool m_LayoutDirty{ true };
 };
 
 }
@@ -6,7 +6,7 @@ zephyr::physics::PhysicsRenderer::PhysicsRenderer(zephyr::rendering::DrawManager
 }
 
 void zephyr::physics::PhysicsRenderer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
-    m_DebugShader->DrawLine(Vector3(from), Vector3(to), Vector3(color));
+    m_DebugShader->StreamLine(Vector3(from), Vector3(to), Vector3(color));
 }
 
 void zephyr::physics::PhysicsRenderer::drawTriangle(const btVector3& v0, const btVector3& v1, const btVector3& v2, const btVector3&, const btVector3&, const btVector3&, const btVector3& color, btScalar alpha) {
@@ -14,7 +14,7 @@ void zephyr::physics::PhysicsRenderer::drawTriangle(const btVector3& v0, const b
 }
 
 void zephyr::physics::PhysicsRenderer::drawTriangle(const btVector3& v0, const btVector3& v1, const btVector3& v2, const btVector3& color, btScalar) {
-    m_DebugShader->DrawTriangle(Vector3(v0), Vector3(v1), Vector3(v2), Vector3(color));
+    m_DebugShader->StreamTriangle(Vector3(v0), Vector3(v1), Vector3(v2), Vector3(color));
 }
 
 void zephyr::physics::PhysicsRenderer::drawPlane(const btVector3& planeNormal, btScalar planeConst, const btTransform& trans, const btVector3& color) {
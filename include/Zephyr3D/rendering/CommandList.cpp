@@ -0,0 +1,123 @@
+#include "CommandList.h"
+
+void zephyr::rendering::CommandList::UseProgram(GLuint program) {
+    Command command{};
+    command.Type = ECommand::UseProgram;
+    command.Name = program;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::BindVertexArray(GLuint vao) {
+    Command command{};
+    command.Type = ECommand::BindVertexArray;
+    command.Name = vao;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::BindBuffer(GLenum target, GLuint buffer) {
+    Command command{};
+    command.Type = ECommand::BindBuffer;
+    command.Target = target;
+    command.Name = buffer;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+    Command command{};
+    command.Type = ECommand::BindTexture;
+    command.Target = target;
+    command.Name = texture;
+    command.Slot = static_cast<GLint>(unit);
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::Uniform(GLint location, int value) {
+    Command command{};
+    command.Type = ECommand::UniformInt;
+    command.Slot = location;
+    command.Int = value;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::Uniform(GLint location, float value) {
+    Command command{};
+    command.Type = ECommand::UniformFloat;
+    command.Slot = location;
+    command.Float = value;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::InstanceMatrix(GLint location, GLuint buffer, std::size_t offset) {
+    Command command{};
+    command.Type = ECommand::InstanceMatrix;
+    command.Target = GL_ARRAY_BUFFER;
+    command.Name = buffer;
+    command.Slot = location;
+    command.Offset = offset;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+    Command command{};
+    command.Type = ECommand::DrawArrays;
+    command.Target = mode;
+    command.Slot = first;
+    command.Count = count;
+    command.Instances = 1;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    Command command{};
+    command.Type = ECommand::DrawArraysInstanced;
+    command.Target = mode;
+    command.Slot = first;
+    command.Count = count;
+    command.Instances = instances;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::DrawElements(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset) {
+    Command command{};
+    command.Type = ECommand::DrawElements;
+    command.Target = mode;
+    command.Count = count;
+    command.Instances = 1;
+    command.IndexType = index_type;
+    command.Offset = offset;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::DrawElementsInstanced(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset, GLsizei instances) {
+    Command command{};
+    command.Type = ECommand::DrawElementsInstanced;
+    command.Target = mode;
+    command.Count = count;
+    command.Instances = instances;
+    command.IndexType = index_type;
+    command.Offset = offset;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset, GLsizei instances, GLint base_vertex) {
+    Command command{};
+    command.Type = ECommand::DrawElementsInstancedBaseVertex;
+    command.Target = mode;
+    command.Slot = base_vertex;
+    command.Count = count;
+    command.Instances = instances;
+    command.IndexType = index_type;
+    command.Offset = offset;
+    m_Commands.push_back(command);
+}
+
+void zephyr::rendering::CommandList::MultiDrawElementsIndirect(GLenum mode, GLenum index_type, GLuint buffer, std::size_t offset, GLsizei draw_count) {
+    Command command{};
+    command.Type = ECommand::MultiDrawElementsIndirect;
+    command.Target = mode;
+    command.Name = buffer;
+    command.Count = draw_count;
+    command.IndexType = index_type;
+    command.Offset = offset;
+    m_Commands.push_back(command);
+}
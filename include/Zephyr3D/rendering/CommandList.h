@@ -0,0 +1,87 @@
+#ifndef CommandList_h
+#define CommandList_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace zephyr::rendering {
+
+enum class ECommand : std::uint8_t {
+    UseProgram,
+    BindVertexArray,
+    BindBuffer,
+    BindTexture,
+    UniformInt,
+    UniformFloat,
+    InstanceMatrix,
+    DrawArrays,
+    DrawArraysInstanced,
+    DrawElements,
+    DrawElementsInstanced,
+    DrawElementsInstancedBaseVertex,
+    MultiDrawElementsIndirect
+};
+
+// State change or draw with its parameters, fields not used by the command are zero
+struct Command {
+    ECommand Type;
+    GLenum Target;      // Buffer or texture target, primitive mode of draws
+    GLuint Name;        // Bound object, indirect buffer of multi draws
+    GLint Slot;         // Texture unit, uniform or attribute location, first or base vertex of draws
+    GLsizei Count;      // Vertices or indices drawn, draws of multi draws
+    GLsizei Instances;
+    GLenum IndexType;
+    GLint Int;
+    float Float;
+    std::size_t Offset; // Bytes into bound element, instance or indirect buffer
+};
+
+// Commands recorded without touching GL
+// Lists are filled on worker threads and replayed on the GL thread by ICommandBackend.
+// Recording doesn't filter redundant state, replaying through StateCache does.
+class CommandList {
+public:
+    CommandList() = default;
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+    CommandList(CommandList&&) = default;
+    CommandList& operator=(CommandList&&) = default;
+    ~CommandList() = default;
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    void Uniform(GLint location, int value);
+    void Uniform(GLint location, float value);
+
+    // Points four per instance attributes starting at location at matrices in buffer
+    // Attributes have to be enabled in bound vertex array already
+    void InstanceMatrix(GLint location, GLuint buffer, std::size_t offset);
+
+    void DrawArrays(GLenum mode, GLint first, GLsizei count);
+    void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+    void DrawElements(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset);
+    void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset, GLsizei instances);
+    void DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum index_type, std::size_t offset, GLsizei instances, GLint base_vertex);
+
+    // Draws tightly packed DrawElementsIndirectCommand structures, needs ARB_multi_draw_indirect
+    void MultiDrawElementsIndirect(GLenum mode, GLenum index_type, GLuint buffer, std::size_t offset, GLsizei draw_count);
+
+    void Clear() { m_Commands.clear(); }
+    bool Empty() const { return m_Commands.empty(); }
+    std::size_t Size() const { return m_Commands.size(); }
+    const std::vector<Command>& Commands() const { return m_Commands; }
+
+private:
+    std::vector<Command> m_Commands;
+};
+
+}
+
+#endif
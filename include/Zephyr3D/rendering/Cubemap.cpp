@@ -1,24 +1,43 @@
 #include "Cubemap.h"
 #include "DrawManager.h"
+#include "Texture.h"
+#include "StateCache.h"
 #include "../resources/Image.h"
+#include "../debuging/Logger.h"
+#include "../utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
 
 zephyr::rendering::Cubemap::Cubemap(const std::string& right, const std::string& left, const std::string& top, const std::string& bottom, const std::string& back, const std::string& front) {
-    m_Load(right, left, top, bottom, back, front);
+    glGenTextures(1, &m_ID);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_CUBE_MAP, m_ID);
+
+    m_Load({ right, left, top, bottom, back, front });
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
     m_Initialize();
 }
 
 zephyr::rendering::Cubemap::Cubemap(const resources::Image& right, const resources::Image& left, const resources::Image& top, const resources::Image& bottom, const resources::Image& back, const resources::Image& front) {
     glGenTextures(1, &m_ID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_CUBE_MAP, m_ID);
 
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_RGB, right.Width(), right.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, right.Data());
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, GL_RGB, left.Width(), left.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, left.Data());
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, GL_RGB, top.Width(), top.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, top.Data());
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, GL_RGB, bottom.Width(), bottom.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, bottom.Data());
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, GL_RGB, back.Width(), back.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, back.Data());
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, GL_RGB, front.Width(), front.Height(), 0, GL_RGB, GL_UNSIGNED_BYTE, front.Data());
+    if (right.Compression() != resources::Image::ECompression::None) {
+        m_UploadCompressed({ &right, &left, &top, &bottom, &back, &front });
+    } else {
+        const auto face = [](const resources::Image& image) {
+            return Face{ image.Data(), image.Width(), image.Height(), image.Components() };
+        };
+        m_Upload({ face(right), face(left), face(top), face(bottom), face(back), face(front) });
+    }
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -27,74 +46,157 @@ zephyr::rendering::Cubemap::Cubemap(const resources::Image& right, const resourc
     m_Initialize();
 }
 
-void zephyr::rendering::Cubemap::Draw(const ShaderProgram& shader) const {
-    shader.Uniform("skybox", 0);
-    
-    glBindVertexArray(m_VAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
+zephyr::rendering::Cubemap::~Cubemap() {
+    StateCache::Instance().DeleteTexture(m_ID);
+    StateCache::Instance().DeleteVertexArray(m_VAO);
+    StateCache::Instance().DeleteBuffer(m_VBO);
+}
+
+void zephyr::rendering::Cubemap::Draw(const ShaderProgram& /*shader*/) const {
+    StateCache::Instance().BindVertexArray(m_VAO);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_CUBE_MAP, m_ID);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+    RenderStats::Frame().Draw(GL_TRIANGLES, 36);
 }
 
-void zephyr::rendering::Cubemap::m_Load(const std::string& right, const std::string& left, const std::string& top, const std::string& bottom, const std::string& back, const std::string& front) {
-    glGenTextures(1, &m_ID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
-    
-    int width, height, nr_channels;
-    unsigned char* data = stbi_load(right.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    } else {
-        std::cout << "Cubemap texture failed to load at path: " << right << '\n';
+void zephyr::rendering::Cubemap::m_Load(const std::array<std::string, 6>& paths) {
+    std::array<Face, 6> faces;
+    std::array<unsigned char*, 6> pixels{};
+
+    // Decoding dominates, faces are spread over workers and GL work waits for all of them
+    ThreadPool::Instance().Run(faces.size(), [&](std::size_t i) {
+        Face& face = faces[i];
+        pixels[i] = stbi_load(paths[i].c_str(), &face.Width, &face.Height, &face.Components, 0);
+        face.Data = pixels[i];
+    });
+
+    for (std::size_t i = 0; i < faces.size(); i++) {
+        if (!pixels[i]) {
+            ERROR_LOG(Logger::ESender::Rendering, "Failed to load cubemap face %s", paths[i].c_str());
+        }
     }
-    stbi_image_free(data);
-    
-    data = stbi_load(left.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    } else {
-        std::cout << "Cubemap texture failed to load at path: " << left << '\n';
+
+    m_Upload(faces);
+
+    for (unsigned char* data : pixels) {
+        stbi_image_free(data);
     }
-    stbi_image_free(data);
-    
-    data = stbi_load(top.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    } else {
-        std::cout << "Cubemap texture failed to load at path: " << top << '\n';
+}
+
+void zephyr::rendering::Cubemap::m_Upload(const std::array<Face, 6>& faces) {
+    const Face& first = faces.front();
+    for (const Face& face : faces) {
+        if (!face.Data || face.Width != first.Width || face.Height != first.Height || face.Components != first.Components) {
+            ERROR_LOG(Logger::ESender::Rendering, "Cubemap faces have to be loaded and share size and format");
+            return;
+        }
     }
-    stbi_image_free(data);
-    
-    data = stbi_load(bottom.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    } else {
-        std::cout << "Cubemap texture failed to load at path: " << bottom << '\n';
+
+    GLenum format = 0;
+    GLenum internal_format = 0;
+    switch (first.Components) {
+    case 1:
+        format = GL_RED;
+        internal_format = GL_R8;
+        break;
+
+    case 3:
+        format = GL_RGB;
+        internal_format = GL_RGB8;
+        break;
+
+    case 4:
+        format = GL_RGBA;
+        internal_format = GL_RGBA8;
+        break;
+
+    default:
+        ERROR_LOG(Logger::ESender::Rendering, "Unsupported cubemap face with %d components", first.Components);
+        return;
     }
-    stbi_image_free(data);
-    
-    data = stbi_load(back.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+
+    const std::size_t face_size = static_cast<std::size_t>(first.Width) * first.Height * first.Components;
+    const GLsizei levels = static_cast<GLsizei>(std::log2(std::max(first.Width, first.Height))) + 1;
+
+    // Immutable storage lets the driver validate whole mip chain once
+    if (GLAD_GL_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, levels, internal_format, first.Width, first.Height);
     } else {
-        std::cout << "Cubemap texture failed to load at path: " << back << '\n';
+        for (GLenum i = 0; i < faces.size(); i++) {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internal_format, first.Width, first.Height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        }
     }
-    stbi_image_free(data);
-    
-    data = stbi_load(front.c_str(), &width, &height, &nr_channels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    } else {
-        std::cout << "Cubemap texture failed to load at path: " << front << '\n';
+
+    // All faces are staged in one unpack buffer, texture uploads then read from GPU side copy
+    GLuint staging = 0;
+    glGenBuffers(1, &staging);
+    StateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, faces.size() * face_size, nullptr, GL_STREAM_DRAW);
+
+    // Rows of RGB faces are not necessarily 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (GLenum i = 0; i < faces.size(); i++) {
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, i * face_size, face_size, faces[i].Data);
+        glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, first.Width, first.Height, format, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(i * face_size));
     }
-    stbi_image_free(data);
-    
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    StateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    StateCache::Instance().DeleteBuffer(staging);
+
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    RenderStats::Frame().Upload(faces.size() * face_size);
+}
+
+void zephyr::rendering::Cubemap::m_UploadCompressed(const std::array<const resources::Image*, 6>& images) {
+    const resources::Image& first = *images.front();
+    for (const resources::Image* image : images) {
+        if (image->Compression() != first.Compression() || image->Width() != first.Width() || image->Height() != first.Height() || image->Levels().size() != first.Levels().size()) {
+            ERROR_LOG(Logger::ESender::Rendering, "Cubemap faces have to share size and compression");
+            return;
+        }
+    }
+
+    // Cooked faces come with precomputed mip chain, blocks are uploaded as they are
+    const GLenum internal_format = Texture::CompressedFormat(first.Compression());
+    const auto& levels = first.Levels();
+    if (GLAD_GL_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, static_cast<GLsizei>(levels.size()), internal_format, levels.front().Width, levels.front().Height);
+    }
+
+    std::size_t total_size = 0;
+    for (const resources::Image* image : images) {
+        total_size += image->Size();
+    }
+
+    GLuint staging = 0;
+    glGenBuffers(1, &staging);
+    StateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, total_size, nullptr, GL_STREAM_DRAW);
+
+    std::size_t offset = 0;
+    for (GLenum i = 0; i < images.size(); i++) {
+        const resources::Image& image = *images[i];
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, offset, image.Size(), image.Data());
+
+        for (std::size_t j = 0; j < levels.size(); j++) {
+            const auto& level = image.Levels()[j];
+            const void* data = reinterpret_cast<const void*>(offset + level.Offset);
+            if (GLAD_GL_ARB_texture_storage) {
+                glCompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, static_cast<GLint>(j), 0, 0, level.Width, level.Height, internal_format, static_cast<GLsizei>(level.Size), data);
+            } else {
+                glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, static_cast<GLint>(j), internal_format, level.Width, level.Height, 0, static_cast<GLsizei>(level.Size), data);
+            }
+        }
+
+        offset += image.Size();
+    }
+
+    StateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    StateCache::Instance().DeleteBuffer(staging);
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+    RenderStats::Frame().Upload(total_size);
 }
 
 void zephyr::rendering::Cubemap::m_Initialize() {
@@ -145,8 +247,8 @@ void zephyr::rendering::Cubemap::m_Initialize() {
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
     
-    glBindVertexArray(m_VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    StateCache::Instance().BindVertexArray(m_VAO);
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, m_VBO);
     
     // Position
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
@@ -154,6 +256,5 @@ void zephyr::rendering::Cubemap::m_Initialize() {
     
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    StateCache::Instance().BindVertexArray(0);
 }
@@ -7,26 +7,39 @@
 #include <stb_image.h>
 #pragma warning(pop)
 
-#include <iostream>
+#include <array>
 #include <string>
 
 namespace zephyr::resources { class Image; }
 
 namespace zephyr::rendering {
 
+// Faces are given in right, left, top, bottom, back, front order
+// Decoded faces are uploaded together through a pixel unpack buffer into immutable
+// storage when the driver supports it, mip chain is generated once all of them arrived.
 class Cubemap : public IDrawable {
 public:
     Cubemap(const std::string& right, const std::string& left, const std::string& top, const std::string& bottom, const std::string& back, const std::string& front);
     Cubemap(const resources::Image& right, const resources::Image& left, const resources::Image& top, const resources::Image& bottom, const resources::Image& back, const resources::Image& front);
+    ~Cubemap();
 
     void Draw(const ShaderProgram& shader) const override;
 
 private:
+    struct Face {
+        const unsigned char* Data{ nullptr };
+        int Width{ 0 };
+        int Height{ 0 };
+        int Components{ 0 };
+    };
+
     unsigned int m_ID;
     unsigned int m_VAO;
     unsigned int m_VBO;
 
-    void m_Load(const std::string& right, const std::string& left, const std::string& top, const std::string& bottom, const std::string& back, const std::string& front);
+    void m_Load(const std::array<std::string, 6>& paths);
+    void m_Upload(const std::array<Face, 6>& faces);
+    void m_UploadCompressed(const std::array<const resources::Image*, 6>& images);
     void m_Initialize();
 };
 
@@ -2,6 +2,8 @@
 #include "ICamera.h"
 #include "IDrawable.h"
 #include "IGUIWidget.h"
+#include "StateCache.h"
+#include "GLCommandBackend.h"
 #include "shaders/PureColor.h"
 #include "shaders/PureTexture.h"
 #include "shaders/Phong.h"
@@ -39,8 +41,10 @@ void zephyr::rendering::DrawManager::Initialize() {
         ERROR_LOG(Logger::ESender::Rendering, "Failed to emplace Phong shader\n");
     }}
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_MULTISAMPLE);
+    m_CommandBackend = std::make_unique<GLCommandBackend>();
+
+    StateCache::Instance().Enable(GL_DEPTH_TEST);
+    StateCache::Instance().Enable(GL_MULTISAMPLE);
 }
 
 void zephyr::rendering::DrawManager::Destroy() {
@@ -76,43 +80,100 @@ void zephyr::rendering::DrawManager::UnregisterGUIWidget(IGUIWidget* widget) {
     }
 }
 
+ImFont* zephyr::rendering::DrawManager::Font(const std::string& path, float size) {
+    return m_Fonts.Font(path, size);
+}
+
 void zephyr::rendering::DrawManager::CallDraws() {
-    glClearColor(m_Background.x, m_Background.y, m_Background.z, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    m_RunPass("Clear", true, [&]() {
+        glClearColor(m_Background.x, m_Background.y, m_Background.z, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Camera data shared by every shader program
+        const CameraBlock camera_block{ m_Camera->Projection() * m_Camera->View(), m_Camera->LocalPosition(), 0.0f };
+        m_CameraBuffer.Update(&camera_block, sizeof(camera_block));
+    });
 
-    // Call draws in all shaders
+    // Call draws in all shaders and collect their packets
+    m_RenderQueue.Clear();
     for (auto it = m_Shaders.begin(); it != m_Shaders.end(); it++) {
         auto& shader = it->second;
 
-        shader->Use();
-        shader->Draw(m_Camera);
+        m_RunPass(it->first, shader->HasWork(), [&]() {
+            shader->Use();
+            shader->Draw(m_Camera);
+            shader->Submit(m_RenderQueue, m_Camera);
+        });
     }
 
-    glm::mat4 pv = m_Camera->Projection() * m_Camera->View();
+    // Draw packets grouped by state, packets of all shaders are interleaved so they share a pass
+    // Workers record command lists, the GL thread replays them in order
+    m_RunPass("RenderQueue", m_RenderQueue.Size() > 0, [&]() {
+        m_RenderQueue.Sort();
+        m_RenderQueue.Record(m_CommandLists);
+        for (const auto& commands : m_CommandLists) {
+            m_CommandBackend->Execute(commands);
+        }
+    });
 
     // Draw debug
-    m_DebugShader.Use();
-    m_DebugShader.Draw(m_Camera);
+    m_RunPass("Debug", m_DebugShader.HasWork(), [&]() {
+        m_DebugShader.Use();
+        m_DebugShader.Draw(m_Camera);
+    });
 
     // Draw skybox
-    m_SkyboxShader.Use();
-    m_SkyboxShader.Draw(m_Camera);
+    m_RunPass("Skybox", m_SkyboxShader.HasWork(), [&]() {
+        m_SkyboxShader.Use();
+        m_SkyboxShader.Draw(m_Camera);
+    });
+
+    // Draw GUI, without widgets ImGui frame isn't started at all
+    m_RunPass("GUI", !m_GUIWidgets.empty(), [&]() {
+        m_Fonts.Update();
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        for (auto widget = m_GUIWidgets.begin(); widget != m_GUIWidgets.end(); widget++) {
+            (*widget)->Draw();
+        }
+
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        ImGui::EndFrame();
+    });
 
-    // Draw GUI
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    // End of drawing
+    glfwSwapBuffers(ZephyrEngine::Instance().Window());
+    m_Statistics = std::exchange(RenderStats::Frame(), RenderStats());
+    m_PassTimer.EndFrame();
+}
 
-    for (auto widget = m_GUIWidgets.begin(); widget != m_GUIWidgets.end(); widget++) {
-        (*widget)->Draw();
+void zephyr::rendering::DrawManager::m_RunPass(const std::string& name, bool has_work, const std::function<void()>& pass) {
+    if (!has_work) {
+        RenderStats::Frame().SkippedPasses++;
+        return;
     }
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-    ImGui::EndFrame();
+    m_PassTimer.Begin(name);
+    pass();
+    m_PassTimer.End();
+    RenderStats::Frame().ExecutedPasses++;
+}
 
-    // End of drawing
-    glfwSwapBuffers(ZephyrEngine::Instance().Window());
+const zephyr::rendering::RenderStats& zephyr::rendering::DrawManager::Statistics() const {
+    return m_Statistics;
+}
+
+void zephyr::rendering::DrawManager::CommandBackend(std::unique_ptr<ICommandBackend> backend) {
+    assert(backend != nullptr);
+
+    m_CommandBackend = std::move(backend);
+}
+
+const std::vector<zephyr::rendering::PassTiming>& zephyr::rendering::DrawManager::PassTimings() const {
+    return m_PassTimer.Timings();
 }
 
 zephyr::rendering::ShaderProgram* zephyr::rendering::DrawManager::Shader(const std::string& name) {
@@ -4,6 +4,12 @@
 #include "IDrawManager.h"
 #include "shaders/SkyboxShader.h"
 #include "shaders/DebugShader.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
+#include "PassTimer.h"
+#include "CommandList.h"
+#include "ICommandBackend.h"
+#include "FontCache.h"
 
 #pragma warning(push, 0)
 #define IMGUI_USER_CONFIG "../dependencies/imconfig.h"
@@ -15,6 +21,7 @@
 #include <GLFW/glfw3.h>
 #pragma warning(pop)
 
+#include <functional>
 #include <iostream>
 #include <stack>
 #include <vector>
@@ -37,18 +44,48 @@ public:
     void RegisterGUIWidget(IGUIWidget* widget) override;
     void UnregisterGUIWidget(IGUIWidget* widget) override;
 
+    // Cached per path and size, atlas is rebuilt once before next GUI pass
+    ImFont* Font(const std::string& path, float size) override;
+
     ShaderProgram* Shader(const std::string& name) override;
 
+    // Counters of the last completed frame
+    const RenderStats& Statistics() const override;
+
+    // Timings of passes few frames back, GPU results are never waited for
+    const std::vector<PassTiming>& PassTimings() const override;
+
+    // Replays recorded command lists, GLCommandBackend unless replaced
+    void CommandBackend(std::unique_ptr<ICommandBackend> backend);
+    ICommandBackend& CommandBackend() const { return *m_CommandBackend; }
+
     void CallDraws();
 
 private:
+    // Camera uniform block in std140 layout
+    struct CameraBlock {
+        glm::mat4 PV;
+        glm::vec3 ViewPosition;
+        float Padding;
+    };
+
     glm::vec3 m_Background{ 0.0f };
 
+    UniformBuffer m_CameraBuffer{ EUniformBlock::Camera, sizeof(CameraBlock) };
     Debug m_DebugShader;
     SkyboxShader m_SkyboxShader;
     ICamera* m_Camera{ nullptr };
     std::map<std::string, std::unique_ptr<ShaderProgram>> m_Shaders;
+    RenderQueue m_RenderQueue;
+    std::vector<CommandList> m_CommandLists;
+    std::unique_ptr<ICommandBackend> m_CommandBackend;
     std::vector<IGUIWidget*> m_GUIWidgets;
+    FontCache m_Fonts;
+    RenderStats m_Statistics;
+    PassTimer m_PassTimer;
+
+    // Times pass with work, counts it as skipped otherwise
+    void m_RunPass(const std::string& name, bool has_work, const std::function<void()>& pass);
 };
 
 }
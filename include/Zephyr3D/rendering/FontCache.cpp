@@ -0,0 +1,54 @@
+#include "FontCache.h"
+
+#include "../debuging/Logger.h"
+
+#pragma warning(push, 0)
+#include "../dependencies/imgui_impl_opengl3.h"
+#pragma warning(pop)
+
+ImFont* zephyr::rendering::FontCache::Font(const std::string& path, float size) {
+    ImGuiIO& io = ImGui::GetIO();
+
+    // Default font at default size is added by DrawManager
+    if (path.empty() && size <= 0.0f) {
+        return io.Fonts->Fonts[0];
+    }
+
+    auto [it, inserted] = m_Fonts.try_emplace({ path, size }, nullptr);
+    if (!inserted) {
+        return it->second;
+    }
+
+    if (path.empty()) {
+        ImFontConfig config;
+        config.SizePixels = size;
+        it->second = io.Fonts->AddFontDefault(&config);
+    } else {
+        it->second = io.Fonts->AddFontFromFileTTF(path.c_str(), size);
+    }
+
+    if (!it->second) {
+        ERROR_LOG(Logger::ESender::Rendering, "Failed to load font %s", path.c_str());
+        it->second = io.Fonts->Fonts[0];
+        return it->second;
+    }
+
+    m_Dirty = true;
+    return it->second;
+}
+
+void zephyr::rendering::FontCache::Update() {
+    if (!m_Dirty) {
+        return;
+    }
+
+    // Before the first frame the backend builds atlas and texture on its own
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.Fonts->TexID) {
+        ImGui_ImplOpenGL3_DestroyFontsTexture();
+        ImGui_ImplOpenGL3_CreateFontsTexture();
+        INFO_LOG(Logger::ESender::Rendering, "Rebuilt font atlas with %d fonts", io.Fonts->Fonts.Size);
+    }
+
+    m_Dirty = false;
+}
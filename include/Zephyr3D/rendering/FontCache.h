@@ -0,0 +1,40 @@
+#ifndef FontCache_h
+#define FontCache_h
+
+#pragma warning(push, 0)
+#define IMGUI_USER_CONFIG "../dependencies/imconfig.h"
+#include <imgui.h>
+#pragma warning(pop)
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace zephyr::rendering {
+
+// Fonts of the ImGui atlas, each (path, size) pair is loaded once
+// Fonts added during a frame are baked together by a single atlas rebuild before next GUI pass.
+// Returned fonts are valid right away, their glyphs and size after the rebuild.
+class FontCache {
+public:
+    FontCache() = default;
+    FontCache(const FontCache&) = delete;
+    FontCache& operator=(const FontCache&) = delete;
+    FontCache(FontCache&&) = delete;
+    FontCache& operator=(FontCache&&) = delete;
+    ~FontCache() = default;
+
+    // Empty path selects ImGui default font, size of zero or less its default size
+    ImFont* Font(const std::string& path, float size);
+
+    // Rebuilds atlas and its texture if fonts were added, call before ImGui::NewFrame
+    void Update();
+
+private:
+    std::map<std::pair<std::string, float>, ImFont*> m_Fonts;
+    bool m_Dirty{ false };
+};
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "GLCommandBackend.h"
+#include "CommandList.h"
+#include "RenderStats.h"
+#include "StateCache.h"
+
+#pragma warning(push, 0)
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+void zephyr::rendering::GLCommandBackend::Execute(const CommandList& commands) {
+    auto& state = StateCache::Instance();
+    auto& stats = RenderStats::Frame();
+
+    for (const auto& command : commands.Commands()) {
+        switch (command.Type) {
+        case ECommand::UseProgram:
+            state.UseProgram(command.Name);
+            break;
+
+        case ECommand::BindVertexArray:
+            state.BindVertexArray(command.Name);
+            break;
+
+        case ECommand::BindBuffer:
+            state.BindBuffer(command.Target, command.Name);
+            break;
+
+        case ECommand::BindTexture:
+            state.BindTexture(static_cast<GLuint>(command.Slot), command.Target, command.Name);
+            break;
+
+        case ECommand::UniformInt:
+            glUniform1i(command.Slot, command.Int);
+            break;
+
+        case ECommand::UniformFloat:
+            glUniform1f(command.Slot, command.Float);
+            break;
+
+        case ECommand::InstanceMatrix:
+            state.BindBuffer(command.Target, command.Name);
+            for (GLuint i = 0; i < 4; i++) {
+                const GLuint location = static_cast<GLuint>(command.Slot) + i;
+                glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(command.Offset + i * sizeof(glm::vec4)));
+            }
+            break;
+
+        case ECommand::DrawArrays:
+            glDrawArrays(command.Target, command.Slot, command.Count);
+            stats.Draw(command.Target, command.Count);
+            break;
+
+        case ECommand::DrawArraysInstanced:
+            glDrawArraysInstanced(command.Target, command.Slot, command.Count, command.Instances);
+            stats.DrawInstanced(command.Target, command.Count, command.Instances);
+            break;
+
+        case ECommand::DrawElements:
+            glDrawElements(command.Target, command.Count, command.IndexType, (void*)command.Offset);
+            stats.Draw(command.Target, command.Count);
+            break;
+
+        case ECommand::DrawElementsInstanced:
+            glDrawElementsInstanced(command.Target, command.Count, command.IndexType, (void*)command.Offset, command.Instances);
+            stats.DrawInstanced(command.Target, command.Count, command.Instances);
+            break;
+
+        case ECommand::DrawElementsInstancedBaseVertex:
+            glDrawElementsInstancedBaseVertex(command.Target, command.Count, command.IndexType, (void*)command.Offset, command.Instances, command.Slot);
+            stats.DrawInstanced(command.Target, command.Count, command.Instances);
+            break;
+
+        // Primitives of indirect draws are counted by the recorder, they aren't known here
+        case ECommand::MultiDrawElementsIndirect:
+            state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, command.Name);
+            glMultiDrawElementsIndirect(command.Target, command.IndexType, (void*)command.Offset, command.Count, 0);
+            stats.MultiDraw(command.Count);
+            break;
+        }
+    }
+}
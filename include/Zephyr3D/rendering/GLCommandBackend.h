@@ -0,0 +1,23 @@
+#ifndef GLCommandBackend_h
+#define GLCommandBackend_h
+
+#include "ICommandBackend.h"
+
+namespace zephyr::rendering {
+
+// Issues commands to OpenGL, state changes are filtered by StateCache
+class GLCommandBackend : public ICommandBackend {
+public:
+    GLCommandBackend() = default;
+    GLCommandBackend(const GLCommandBackend&) = delete;
+    GLCommandBackend& operator=(const GLCommandBackend&) = delete;
+    GLCommandBackend(GLCommandBackend&&) = delete;
+    GLCommandBackend& operator=(GLCommandBackend&&) = delete;
+    ~GLCommandBackend() = default;
+
+    void Execute(const CommandList& commands) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "GeometryArena.h"
+
+#include "StateCache.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace {
+
+std::size_t IndexSize(GLenum index_type) {
+    return index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+}
+
+zephyr::rendering::GeometryArena::Allocation zephyr::rendering::GeometryArena::Allocate(const VertexFormat& format, const void* vertices, GLsizei vertex_count, const void* indices, GLsizei index_count) {
+    assert(vertex_count > 0 && index_count > 0);
+
+    std::optional<std::size_t> first_vertex;
+    std::optional<std::size_t> first_index;
+    std::size_t pool_index = NO_POOL;
+
+    for (std::size_t i = 0; i < m_Pools.size(); i++) {
+        Pool& pool = m_Pools[i];
+        if (pool.Allocations == 0 || !(pool.Format == format)) {
+            continue;
+        }
+
+        first_vertex = pool.Vertices.Allocate(vertex_count);
+        if (!first_vertex) {
+            continue;
+        }
+
+        first_index = pool.Indices.Allocate(index_count);
+        if (!first_index) {
+            pool.Vertices.Free(*first_vertex, vertex_count);
+            continue;
+        }
+
+        pool_index = i;
+        break;
+    }
+
+    if (pool_index == NO_POOL) {
+        pool_index = CreatePool(format, vertex_count, index_count);
+        first_vertex = m_Pools[pool_index].Vertices.Allocate(vertex_count);
+        first_index = m_Pools[pool_index].Indices.Allocate(index_count);
+    }
+
+    Pool& pool = m_Pools[pool_index];
+    pool.Allocations++;
+
+    const std::size_t index_size = IndexSize(format.IndexType);
+
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, *first_vertex * format.Stride, static_cast<std::size_t>(vertex_count) * format.Stride, vertices);
+
+    // Element array binding is vertex array state
+    StateCache::Instance().BindVertexArray(pool.VAO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, *first_index * index_size, index_count * index_size, indices);
+
+    RenderStats::Frame().Upload(static_cast<std::size_t>(vertex_count) * format.Stride + index_count * index_size);
+
+    Allocation allocation;
+    allocation.Pool = pool_index;
+    allocation.BaseVertex = static_cast<GLint>(*first_vertex);
+    allocation.FirstIndex = static_cast<GLsizei>(*first_index);
+    allocation.VertexCount = vertex_count;
+    allocation.IndexCount = index_count;
+    return allocation;
+}
+
+void zephyr::rendering::GeometryArena::Free(const Allocation& allocation) {
+    // Pools released before the mesh took their ranges with them
+    if (allocation.Pool >= m_Pools.size() || m_Pools[allocation.Pool].Allocations == 0) {
+        return;
+    }
+
+    Pool& pool = m_Pools[allocation.Pool];
+    pool.Vertices.Free(allocation.BaseVertex, allocation.VertexCount);
+    pool.Indices.Free(allocation.FirstIndex, allocation.IndexCount);
+
+    if (--pool.Allocations == 0) {
+        INFO_LOG(Logger::ESender::Rendering, "Deleted empty geometry pool of %zu vertices and %zu indices", pool.VertexCapacity, pool.IndexCapacity);
+        DeletePool(pool);
+    }
+}
+
+void zephyr::rendering::GeometryArena::Release() {
+    for (auto& pool : m_Pools) {
+        if (pool.Allocations > 0) {
+            DeletePool(pool);
+        }
+    }
+
+    m_Pools.clear();
+}
+
+std::size_t zephyr::rendering::GeometryArena::Size() const {
+    std::size_t size = 0;
+    for (const auto& pool : m_Pools) {
+        if (pool.Allocations == 0) {
+            continue;
+        }
+
+        size += pool.VertexCapacity * pool.Format.Stride + pool.IndexCapacity * IndexSize(pool.Format.IndexType);
+    }
+
+    return size;
+}
+
+std::size_t zephyr::rendering::GeometryArena::CreatePool(const VertexFormat& format, std::size_t min_vertices, std::size_t min_indices) {
+    const std::size_t vertex_capacity = std::max(VERTEX_POOL_SIZE / format.Stride, min_vertices);
+    const std::size_t index_capacity = std::max(INDEX_POOL_SIZE / IndexSize(format.IndexType), min_indices);
+
+    GLuint vao, vbo, ebo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    StateCache::Instance().BindVertexArray(vao);
+
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertex_capacity * format.Stride, nullptr, GL_STATIC_DRAW);
+
+    StateCache::Instance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_capacity * IndexSize(format.IndexType), nullptr, GL_STATIC_DRAW);
+
+    for (const auto& attribute : format.Attributes) {
+        glEnableVertexAttribArray(attribute.Location);
+        if (attribute.Normalized || attribute.Type == GL_FLOAT || attribute.Type == GL_HALF_FLOAT) {
+            glVertexAttribPointer(attribute.Location, attribute.Size, attribute.Type, attribute.Normalized, format.Stride, reinterpret_cast<void*>(attribute.Offset));
+        } else {
+            glVertexAttribIPointer(attribute.Location, attribute.Size, attribute.Type, format.Stride, reinterpret_cast<void*>(attribute.Offset));
+        }
+    }
+
+    // Instance attributes stay enabled, draws only point them into their instance buffer
+    for (GLuint i = 0; i < format.InstanceLocations; i++) {
+        glEnableVertexAttribArray(format.FirstInstanceLocation + i);
+        glVertexAttribDivisor(format.FirstInstanceLocation + i, 1);
+    }
+
+    INFO_LOG(Logger::ESender::Rendering, "Created geometry pool of %zu vertices and %zu indices", vertex_capacity, index_capacity);
+
+    Pool pool{ format, vao, vbo, ebo, vertex_capacity, index_capacity, FreeList(vertex_capacity), FreeList(index_capacity), 0 };
+
+    // Slot of deleted pool is reused, allocations refer to pools by index
+    const auto deleted = std::find_if(m_Pools.begin(), m_Pools.end(), [](const Pool& pool) { return pool.Allocations == 0; });
+    if (deleted != m_Pools.end()) {
+        *deleted = std::move(pool);
+        return deleted - m_Pools.begin();
+    }
+
+    m_Pools.push_back(std::move(pool));
+    return m_Pools.size() - 1;
+}
+
+void zephyr::rendering::GeometryArena::DeletePool(Pool& pool) {
+    StateCache::Instance().DeleteVertexArray(pool.VAO);
+    StateCache::Instance().DeleteBuffer(pool.VBO);
+    StateCache::Instance().DeleteBuffer(pool.EBO);
+
+    pool.VAO = pool.VBO = pool.EBO = 0;
+    pool.Allocations = 0;
+}
+
+std::optional<std::size_t> zephyr::rendering::GeometryArena::FreeList::Allocate(std::size_t size) {
+    for (auto it = m_Free.begin(); it != m_Free.end(); ++it) {
+        if (it->second < size) {
+            continue;
+        }
+
+        const std::size_t offset = it->first;
+        const std::size_t remaining = it->second - size;
+        m_Free.erase(it);
+        if (remaining > 0) {
+            m_Free.emplace(offset + size, remaining);
+        }
+
+        return offset;
+    }
+
+    return std::nullopt;
+}
+
+void zephyr::rendering::GeometryArena::FreeList::Free(std::size_t offset, std::size_t size) {
+    auto it = m_Free.emplace(offset, size).first;
+
+    auto next = std::next(it);
+    if (next != m_Free.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        m_Free.erase(next);
+    }
+
+    if (it != m_Free.begin()) {
+        auto previous = std::prev(it);
+        if (previous->first + previous->second == it->first) {
+            previous->second += it->second;
+            m_Free.erase(it);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef GeometryArena_h
+#define GeometryArena_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include "../debuging/Logger.h"
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace zephyr::rendering {
+
+// Static geometry suballocated from few large shared buffers
+// Meshes with the same vertex format share one vertex array, drawing them one after another
+// needs no vertex array switch and lets whole buckets go out in a single multi draw call.
+// Indices are local to their mesh, draws add BaseVertex.
+class GeometryArena {
+public:
+    static constexpr std::size_t NO_POOL = std::numeric_limits<std::size_t>::max();
+
+    // Capacity of new pools in bytes, larger meshes get a pool sized for them
+    static constexpr std::size_t VERTEX_POOL_SIZE = 32 * 1024 * 1024;
+    static constexpr std::size_t INDEX_POOL_SIZE = 16 * 1024 * 1024;
+
+    struct VertexAttribute {
+        GLuint Location;
+        GLint Size;
+        GLenum Type;
+        GLboolean Normalized;
+        std::size_t Offset;
+
+        bool operator==(const VertexAttribute& other) const {
+            return Location == other.Location && Size == other.Size && Type == other.Type && Normalized == other.Normalized && Offset == other.Offset;
+        }
+    };
+
+    struct VertexFormat {
+        std::vector<VertexAttribute> Attributes;
+        GLsizei Stride;
+        GLenum IndexType;
+
+        // Locations with divisor 1, pointed at instance data at draw time
+        GLuint FirstInstanceLocation;
+        GLuint InstanceLocations;
+
+        bool operator==(const VertexFormat& other) const {
+            return Attributes == other.Attributes && Stride == other.Stride && IndexType == other.IndexType
+                && FirstInstanceLocation == other.FirstInstanceLocation && InstanceLocations == other.InstanceLocations;
+        }
+    };
+
+    struct Allocation {
+        std::size_t Pool{ NO_POOL };
+        GLint BaseVertex{ 0 };
+        GLsizei FirstIndex{ 0 };
+        GLsizei VertexCount{ 0 };
+        GLsizei IndexCount{ 0 };
+    };
+
+    static GeometryArena& Instance() {
+        static GeometryArena instance;
+        return instance;
+    }
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+    GeometryArena(GeometryArena&&) = delete;
+    GeometryArena& operator=(GeometryArena&&) = delete;
+
+    Allocation Allocate(const VertexFormat& format, const void* vertices, GLsizei vertex_count, const void* indices, GLsizei index_count);
+
+    // Pool left without allocations is deleted, its index is reused by the next created pool
+    void Free(const Allocation& allocation);
+
+    // Deletes all pools, called while GL context is still alive
+    void Release();
+
+    GLuint VAO(std::size_t pool) const { return m_Pools[pool].VAO; }
+    GLenum IndexType(std::size_t pool) const { return m_Pools[pool].Format.IndexType; }
+    std::size_t PoolCount() const { return m_Pools.size(); }
+
+    // Video memory reserved by live pools in bytes
+    std::size_t Size() const;
+
+private:
+    // First fit allocator of ranges, freed neighbours are merged
+    class FreeList {
+    public:
+        explicit FreeList(std::size_t capacity) { m_Free.emplace(0, capacity); }
+
+        std::optional<std::size_t> Allocate(std::size_t size);
+        void Free(std::size_t offset, std::size_t size);
+
+    private:
+        std::map<std::size_t /*offset*/, std::size_t /*size*/> m_Free;
+    };
+
+    struct Pool {
+        VertexFormat Format;
+        GLuint VAO;
+        GLuint VBO;
+        GLuint EBO;
+        std::size_t VertexCapacity;    // In vertices
+        std::size_t IndexCapacity;     // In indices
+        FreeList Vertices;
+        FreeList Indices;
+        std::size_t Allocations;       // Pool is deleted when it drops to 0
+    };
+
+    GeometryArena() = default;
+    ~GeometryArena() = default;
+
+    std::size_t CreatePool(const VertexFormat& format, std::size_t min_vertices, std::size_t min_indices);
+    void DeletePool(Pool& pool);
+
+    std::vector<Pool> m_Pools;
+};
+
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef ICommandBackend_h
+#define ICommandBackend_h
+
+namespace zephyr::rendering {
+
+class CommandList;
+
+// Replays recorded command lists, called only from the GL thread
+class ICommandBackend {
+public:
+    ICommandBackend() = default;
+    ICommandBackend(const ICommandBackend&) = delete;
+    ICommandBackend& operator=(const ICommandBackend&) = delete;
+    ICommandBackend(ICommandBackend&&) = delete;
+    ICommandBackend& operator=(ICommandBackend&&) = delete;
+    virtual ~ICommandBackend() = default;
+
+    virtual void Execute(const CommandList& commands) = 0;
+};
+
+}
+
+#endif
@@ -5,7 +5,13 @@
 #include <glm/glm.hpp>
 #pragma warning(pop)
 
+#include "RenderStats.h"
+#include "PassTimer.h"
+
 #include <string>
+#include <vector>
+
+struct ImFont;
 
 namespace zephyr::resources {
     class Image;
@@ -35,6 +41,9 @@ public:
     virtual ShaderProgram* Shader(const std::string& name) = 0;
     virtual void RegisterGUIWidget(IGUIWidget* widget) = 0;
     virtual void UnregisterGUIWidget(IGUIWidget* widget) = 0;
+    virtual ImFont* Font(const std::string& path, float size) = 0;
+    virtual const RenderStats& Statistics() const = 0;
+    virtual const std::vector<PassTiming>& PassTimings() const = 0;
 };
 
 }
@@ -0,0 +1,196 @@
+#include "LightClusters.h"
+#include "StateCache.h"
+#include "../utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Light contribution below one 8 bit step is not visible
+constexpr float LIGHT_THRESHOLD = 1.0f / 256.0f;
+
+bool Intersects(const zephyr::rendering::AABB& box, const glm::vec3& center, float radius) {
+    const glm::vec3 closest = glm::clamp(center, box.Min, box.Max);
+    const glm::vec3 offset = closest - center;
+
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+}
+
+zephyr::rendering::LightClusters::LightClusters()
+    : m_Bounds(CLUSTERS_COUNT)
+    , m_Grid(CLUSTERS_COUNT) {
+    CreateTextureBuffer(m_LightData, GL_RGBA32F);
+    CreateTextureBuffer(m_GridBuffer, GL_RG32UI);
+    CreateTextureBuffer(m_IndicesBuffer, GL_R32UI);
+}
+
+zephyr::rendering::LightClusters::~LightClusters() {
+    for (auto buffer : { &m_LightData, &m_GridBuffer, &m_IndicesBuffer }) {
+        StateCache::Instance().DeleteTexture(buffer->Texture);
+        StateCache::Instance().DeleteBuffer(buffer->Buffer);
+    }
+}
+
+void zephyr::rendering::LightClusters::Assign(const glm::mat4& projection, const glm::mat4& view, const std::vector<LightVolume>& lights) {
+    if (projection != m_Projection) {
+        BuildBounds(projection);
+    }
+
+    m_ViewLights.resize(lights.size());
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        m_ViewLights[i] = { glm::vec3(view * glm::vec4(lights[i].Position, 1.0f)), lights[i].Radius };
+    }
+
+    // Workers own contiguous ranges of depth slices, so their clusters don't overlap
+    const GLuint workers = lights.size() > 32 ? std::clamp<GLuint>(static_cast<GLuint>(ThreadPool::Instance().Workers()), 1, CLUSTERS_Z) : 1;
+    const GLuint slices_per_worker = (CLUSTERS_Z + workers - 1) / workers;
+    m_WorkerIndices.resize(workers);
+
+    ThreadPool::Instance().Run(workers, [this, slices_per_worker](std::size_t worker) {
+        const auto first = static_cast<GLuint>(worker) * slices_per_worker;
+        AssignSlices(std::min(first, CLUSTERS_Z), std::min(first + slices_per_worker, CLUSTERS_Z), m_WorkerIndices[worker]);
+    });
+
+    // Concatenate worker lists, offsets were written relative to worker list
+    m_Indices.clear();
+    for (GLuint worker = 0; worker < workers; worker++) {
+        const auto base = static_cast<GLuint>(m_Indices.size());
+        const GLuint first = std::min(worker * slices_per_worker, CLUSTERS_Z) * CLUSTERS_X * CLUSTERS_Y;
+        const GLuint last = std::min((worker + 1) * slices_per_worker, CLUSTERS_Z) * CLUSTERS_X * CLUSTERS_Y;
+        for (GLuint cluster = first; cluster < last; cluster++) {
+            m_Grid[cluster].x += base;
+        }
+
+        m_Indices.insert(m_Indices.end(), m_WorkerIndices[worker].begin(), m_WorkerIndices[worker].end());
+    }
+
+    Upload(m_GridBuffer, m_Grid.data(), m_Grid.size() * sizeof(glm::uvec2));
+    if (!m_Indices.empty()) {
+        Upload(m_IndicesBuffer, m_Indices.data(), m_Indices.size() * sizeof(GLuint));
+    }
+}
+
+void zephyr::rendering::LightClusters::UploadLightData(const std::vector<glm::vec4>& texels) {
+    if (!texels.empty()) {
+        Upload(m_LightData, texels.data(), texels.size() * sizeof(glm::vec4));
+    }
+}
+
+void zephyr::rendering::LightClusters::Bind(GLuint first_unit) const {
+    StateCache::Instance().BindTexture(first_unit, GL_TEXTURE_BUFFER, m_LightData.Texture);
+    StateCache::Instance().BindTexture(first_unit + 1, GL_TEXTURE_BUFFER, m_GridBuffer.Texture);
+    StateCache::Instance().BindTexture(first_unit + 2, GL_TEXTURE_BUFFER, m_IndicesBuffer.Texture);
+}
+
+void zephyr::rendering::LightClusters::Bind(CommandList& commands, GLuint first_unit) const {
+    commands.BindTexture(first_unit, GL_TEXTURE_BUFFER, m_LightData.Texture);
+    commands.BindTexture(first_unit + 1, GL_TEXTURE_BUFFER, m_GridBuffer.Texture);
+    commands.BindTexture(first_unit + 2, GL_TEXTURE_BUFFER, m_IndicesBuffer.Texture);
+}
+
+float zephyr::rendering::LightClusters::AttenuationRadius(float constant, float linear, float quadratic, float intensity) {
+    // Solve intensity / (constant + linear * d + quadratic * d^2) = threshold
+    const float target = intensity / LIGHT_THRESHOLD;
+    if (constant >= target) {
+        return 0.0f;
+    }
+
+    if (quadratic > 0.0f) {
+        return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * (constant - target))) / (2.0f * quadratic);
+    }
+
+    if (linear > 0.0f) {
+        return (target - constant) / linear;
+    }
+
+    return std::numeric_limits<float>::max();
+}
+
+void zephyr::rendering::LightClusters::BuildBounds(const glm::mat4& projection) {
+    m_Projection = projection;
+    m_Near = projection[3][2] / (projection[2][2] - 1.0f);
+    m_Far = projection[3][2] / (projection[2][2] + 1.0f);
+
+    const glm::mat4 inverse_projection = glm::inverse(projection);
+
+    // Point on near plane for given NDC, scaled along the view ray to requested depth
+    auto unproject = [&](float x, float y, float depth) {
+        const glm::vec4 point = inverse_projection * glm::vec4(x, y, -1.0f, 1.0f);
+        const glm::vec3 near_point = glm::vec3(point) / point.w;
+        return near_point * (depth / -near_point.z);
+    };
+
+    for (GLuint z = 0; z < CLUSTERS_Z; z++) {
+        const float depth_near = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z) / CLUSTERS_Z);
+        const float depth_far = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z + 1) / CLUSTERS_Z);
+
+        for (GLuint y = 0; y < CLUSTERS_Y; y++) {
+            const float y0 = -1.0f + 2.0f * y / CLUSTERS_Y;
+            const float y1 = -1.0f + 2.0f * (y + 1) / CLUSTERS_Y;
+
+            for (GLuint x = 0; x < CLUSTERS_X; x++) {
+                const float x0 = -1.0f + 2.0f * x / CLUSTERS_X;
+                const float x1 = -1.0f + 2.0f * (x + 1) / CLUSTERS_X;
+
+                AABB& bounds = m_Bounds[(z * CLUSTERS_Y + y) * CLUSTERS_X + x];
+                bounds = AABB();
+                for (float depth : { depth_near, depth_far }) {
+                    bounds.Expand(unproject(x0, y0, depth));
+                    bounds.Expand(unproject(x1, y0, depth));
+                    bounds.Expand(unproject(x0, y1, depth));
+                    bounds.Expand(unproject(x1, y1, depth));
+                }
+            }
+        }
+    }
+}
+
+void zephyr::rendering::LightClusters::AssignSlices(GLuint first_slice, GLuint last_slice, std::vector<GLuint>& indices) {
+    indices.clear();
+
+    for (GLuint z = first_slice; z < last_slice; z++) {
+        const GLuint slice_begin = z * CLUSTERS_X * CLUSTERS_Y;
+        const AABB& slice_bounds = m_Bounds[slice_begin];
+
+        // Lights reaching depth range of the slice
+        std::vector<GLuint> slice_lights;
+        for (GLuint light = 0; light < m_ViewLights.size(); light++) {
+            const auto& [position, radius] = m_ViewLights[light];
+            if (radius > 0.0f && position.z - radius <= slice_bounds.Max.z && position.z + radius >= slice_bounds.Min.z) {
+                slice_lights.push_back(light);
+            }
+        }
+
+        for (GLuint cluster = slice_begin; cluster < slice_begin + CLUSTERS_X * CLUSTERS_Y; cluster++) {
+            m_Grid[cluster] = glm::uvec2(static_cast<GLuint>(indices.size()), 0);
+
+            for (auto light : slice_lights) {
+                if (Intersects(m_Bounds[cluster], m_ViewLights[light].Position, m_ViewLights[light].Radius)) {
+                    indices.push_back(light);
+                    m_Grid[cluster].y++;
+                }
+            }
+        }
+    }
+}
+
+void zephyr::rendering::LightClusters::CreateTextureBuffer(TextureBuffer& buffer, GLenum format) {
+    glGenBuffers(1, &buffer.Buffer);
+    StateCache::Instance().BindBuffer(GL_TEXTURE_BUFFER, buffer.Buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &buffer.Texture);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_BUFFER, buffer.Texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer.Buffer);
+}
+
+void zephyr::rendering::LightClusters::Upload(const TextureBuffer& buffer, const void* data, std::size_t size) {
+    // Orphan previous storage, the driver doesn't wait for draws still reading it
+    StateCache::Instance().BindBuffer(GL_TEXTURE_BUFFER, buffer.Buffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+    RenderStats::Frame().Upload(size);
+}
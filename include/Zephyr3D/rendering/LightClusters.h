@@ -0,0 +1,85 @@
+#ifndef LightClusters_h
+#define LightClusters_h
+
+#include "CommandList.h"
+#include "culling/AABB.h"
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <vector>
+
+namespace zephyr::rendering {
+
+// View space froxel grid used by clustered forward shading
+// Slices are distributed exponentially between near and far plane. Every cluster keeps
+// offset and count into a list of light indices, both uploaded as texture buffers.
+class LightClusters {
+public:
+    static constexpr GLuint CLUSTERS_X = 16;
+    static constexpr GLuint CLUSTERS_Y = 9;
+    static constexpr GLuint CLUSTERS_Z = 24;
+    static constexpr GLuint CLUSTERS_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+    // World space sphere of light influence
+    struct LightVolume {
+        glm::vec3 Position;
+        float Radius;
+    };
+
+    LightClusters();
+
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+    LightClusters(LightClusters&&) = delete;
+    LightClusters& operator=(LightClusters&&) = delete;
+    ~LightClusters();
+
+    // Assigns lights to clusters of the camera and uploads the grid
+    void Assign(const glm::mat4& projection, const glm::mat4& view, const std::vector<LightVolume>& lights);
+
+    // Per light parameters fetched by index from light list
+    void UploadLightData(const std::vector<glm::vec4>& texels);
+
+    // Binds light data, grid and index list to three consecutive texture units
+    void Bind(GLuint first_unit) const;
+    void Bind(CommandList& commands, GLuint first_unit) const;
+
+    float Near() const { return m_Near; }
+    float Far() const { return m_Far; }
+    std::size_t IndicesCount() const { return m_Indices.size(); }
+
+    // Distance at which attenuated light drops below visible threshold
+    static float AttenuationRadius(float constant, float linear, float quadratic, float intensity);
+
+private:
+    struct TextureBuffer {
+        GLuint Buffer{ 0 };
+        GLuint Texture{ 0 };
+    };
+
+    glm::mat4 m_Projection{ 0.0f };
+    float m_Near{ 0.0f };
+    float m_Far{ 0.0f };
+    std::vector<AABB> m_Bounds;                 // View space bounds of each cluster
+
+    std::vector<glm::uvec2> m_Grid;             // Offset and count into m_Indices
+    std::vector<GLuint> m_Indices;
+    std::vector<std::vector<GLuint>> m_WorkerIndices;
+    std::vector<LightVolume> m_ViewLights;
+
+    TextureBuffer m_LightData;
+    TextureBuffer m_GridBuffer;
+    TextureBuffer m_IndicesBuffer;
+
+    void BuildBounds(const glm::mat4& projection);
+    void AssignSlices(GLuint first_slice, GLuint last_slice, std::vector<GLuint>& indices);
+    static void CreateTextureBuffer(TextureBuffer& buffer, GLenum format);
+    static void Upload(const TextureBuffer& buffer, const void* data, std::size_t size);
+};
+
+}
+
+#endif
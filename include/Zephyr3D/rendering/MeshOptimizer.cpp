@@ -0,0 +1,382 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+// Forsyth's scoring parameters
+constexpr std::size_t FORSYTH_CACHE_SIZE = 32;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Resolution of overdraw estimation views
+constexpr int OVERDRAW_GRID = 128;
+
+struct VertexHash {
+    std::size_t operator()(const zephyr::rendering::MeshVertex& vertex) const {
+        const float* data = &vertex.Position.x;
+        std::size_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < sizeof(vertex) / sizeof(float); i++) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &data[i], sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+};
+
+float VertexScore(int cache_position, unsigned int remaining_triangles) {
+    if (remaining_triangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cache_position >= 0) {
+        if (cache_position < 3) {
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cache_position - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining_triangles), -VALENCE_BOOST_POWER);
+}
+
+}
+
+zephyr::rendering::MeshOptimizer::MeshOptimizer(std::vector<MeshVertex> vertices, std::vector<GLuint> indices)
+    : m_Vertices(std::move(vertices))
+    , m_Indices(std::move(indices)) {
+    assert(m_Indices.size() % 3 == 0);
+}
+
+void zephyr::rendering::MeshOptimizer::Deduplicate() {
+    std::unordered_map<MeshVertex, GLuint, VertexHash> unique;
+    unique.reserve(m_Vertices.size());
+
+    std::vector<GLuint> remap(m_Vertices.size());
+    std::vector<MeshVertex> vertices;
+    vertices.reserve(m_Vertices.size());
+
+    for (std::size_t i = 0; i < m_Vertices.size(); i++) {
+        auto [it, inserted] = unique.try_emplace(m_Vertices[i], static_cast<GLuint>(vertices.size()));
+        if (inserted) {
+            vertices.push_back(m_Vertices[i]);
+        }
+
+        remap[i] = it->second;
+    }
+
+    for (auto& index : m_Indices) {
+        index = remap[index];
+    }
+
+    m_Vertices = std::move(vertices);
+}
+
+void zephyr::rendering::MeshOptimizer::OptimizeVertexCache() {
+    const std::size_t triangle_count = m_Indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Triangles adjacent to each vertex
+    std::vector<unsigned int> remaining(m_Vertices.size(), 0);
+    for (auto index : m_Indices) {
+        remaining[index]++;
+    }
+
+    std::vector<std::size_t> adjacency_offsets(m_Vertices.size() + 1, 0);
+    for (std::size_t i = 0; i < m_Vertices.size(); i++) {
+        adjacency_offsets[i + 1] = adjacency_offsets[i] + remaining[i];
+    }
+
+    std::vector<GLuint> adjacency(m_Indices.size());
+    std::vector<std::size_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+    for (std::size_t i = 0; i < m_Indices.size(); i++) {
+        adjacency[fill[m_Indices[i]]++] = static_cast<GLuint>(i / 3);
+    }
+
+    std::vector<int> cache_position(m_Vertices.size(), -1);
+    std::vector<float> vertex_score(m_Vertices.size());
+    for (std::size_t i = 0; i < m_Vertices.size(); i++) {
+        vertex_score[i] = VertexScore(-1, remaining[i]);
+    }
+
+    std::vector<float> triangle_score(triangle_count);
+    std::vector<bool> emitted(triangle_count, false);
+    for (std::size_t t = 0; t < triangle_count; t++) {
+        triangle_score[t] = vertex_score[m_Indices[t * 3]] + vertex_score[m_Indices[t * 3 + 1]] + vertex_score[m_Indices[t * 3 + 2]];
+    }
+
+    std::vector<GLuint> result;
+    result.reserve(m_Indices.size());
+    std::vector<GLuint> cache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    std::size_t best_triangle = std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin();
+    std::size_t scan_cursor = 0;
+
+    while (result.size() < m_Indices.size()) {
+        const GLuint* triangle = &m_Indices[best_triangle * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[best_triangle] = true;
+
+        // Move triangle vertices to the front of LRU cache
+        std::vector<GLuint> new_cache(triangle, triangle + 3);
+        for (auto vertex : cache) {
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+                new_cache.push_back(vertex);
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            remaining[triangle[i]]--;
+        }
+
+        // Vertices pushed out of cache lose cache position
+        for (std::size_t i = FORSYTH_CACHE_SIZE; i < new_cache.size(); i++) {
+            cache_position[new_cache[i]] = -1;
+            vertex_score[new_cache[i]] = VertexScore(-1, remaining[new_cache[i]]);
+        }
+
+        new_cache.resize(std::min(new_cache.size(), FORSYTH_CACHE_SIZE));
+        cache = std::move(new_cache);
+
+        // Rescore cached vertices and their triangles, best one is picked from them
+        for (std::size_t i = 0; i < cache.size(); i++) {
+            cache_position[cache[i]] = static_cast<int>(i);
+            vertex_score[cache[i]] = VertexScore(static_cast<int>(i), remaining[cache[i]]);
+        }
+
+        float best_score = -1.0f;
+        for (auto vertex : cache) {
+            for (std::size_t a = adjacency_offsets[vertex]; a < adjacency_offsets[vertex + 1]; a++) {
+                const GLuint t = adjacency[a];
+                if (emitted[t]) {
+                    continue;
+                }
+
+                triangle_score[t] = vertex_score[m_Indices[t * 3]] + vertex_score[m_Indices[t * 3 + 1]] + vertex_score[m_Indices[t * 3 + 2]];
+                if (triangle_score[t] > best_score) {
+                    best_score = triangle_score[t];
+                    best_triangle = t;
+                }
+            }
+        }
+
+        // Cache has no unemitted neighbours, continue with next triangle in file order
+        if (best_score < 0.0f) {
+            while (scan_cursor < triangle_count && emitted[scan_cursor]) {
+                scan_cursor++;
+            }
+
+            best_triangle = scan_cursor;
+            if (scan_cursor == triangle_count) {
+                break;
+            }
+        }
+    }
+
+    m_Indices = std::move(result);
+}
+
+void zephyr::rendering::MeshOptimizer::OptimizeOverdraw() {
+    const std::size_t triangle_count = m_Indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Clusters start at triangles missing cache with every vertex, reordering them keeps ACMR
+    std::vector<std::size_t> clusters;
+    std::deque<GLuint> cache;
+    for (std::size_t t = 0; t < triangle_count; t++) {
+        int misses = 0;
+        for (int i = 0; i < 3; i++) {
+            const GLuint vertex = m_Indices[t * 3 + i];
+            if (std::find(cache.begin(), cache.end(), vertex) == cache.end()) {
+                misses++;
+                cache.push_back(vertex);
+                if (cache.size() > CACHE_SIZE) {
+                    cache.pop_front();
+                }
+            }
+        }
+
+        if (t == 0 || misses == 3) {
+            clusters.push_back(t);
+        }
+    }
+    clusters.push_back(triangle_count);
+
+    glm::vec3 mesh_center(0.0f);
+    for (const auto& vertex : m_Vertices) {
+        mesh_center += vertex.Position;
+    }
+    mesh_center /= static_cast<float>(std::max<std::size_t>(m_Vertices.size(), 1));
+
+    // Clusters facing away from mesh center occlude the rest and go first
+    std::vector<std::pair<float /*sort key*/, std::size_t /*cluster*/>> order;
+    order.reserve(clusters.size() - 1);
+    for (std::size_t c = 0; c + 1 < clusters.size(); c++) {
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+
+        for (std::size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const glm::vec3& p0 = m_Vertices[m_Indices[t * 3]].Position;
+            const glm::vec3& p1 = m_Vertices[m_Indices[t * 3 + 1]].Position;
+            const glm::vec3& p2 = m_Vertices[m_Indices[t * 3 + 2]].Position;
+
+            const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+            const float triangle_area = glm::length(cross) * 0.5f;
+            centroid += (p0 + p1 + p2) / 3.0f * triangle_area;
+            normal += cross;
+            area += triangle_area;
+        }
+
+        if (area > 0.0f) {
+            centroid /= area;
+        }
+
+        const float length = glm::length(normal);
+        order.emplace_back(length > 0.0f ? glm::dot(centroid - mesh_center, normal / length) : 0.0f, c);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    std::vector<GLuint> result;
+    result.reserve(m_Indices.size());
+    for (const auto& [key, c] : order) {
+        result.insert(result.end(), m_Indices.begin() + clusters[c] * 3, m_Indices.begin() + clusters[c + 1] * 3);
+    }
+
+    m_Indices = std::move(result);
+}
+
+void zephyr::rendering::MeshOptimizer::OptimizeVertexFetch() {
+    constexpr GLuint UNUSED = static_cast<GLuint>(-1);
+
+    std::vector<GLuint> remap(m_Vertices.size(), UNUSED);
+    std::vector<MeshVertex> vertices;
+    vertices.reserve(m_Vertices.size());
+
+    for (auto& index : m_Indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<GLuint>(vertices.size());
+            vertices.push_back(m_Vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    m_Vertices = std::move(vertices);
+}
+
+float zephyr::rendering::MeshOptimizer::ACMR() const {
+    if (m_Indices.size() < 3) {
+        return 0.0f;
+    }
+
+    std::deque<GLuint> cache;
+    std::size_t misses = 0;
+    for (auto index : m_Indices) {
+        if (std::find(cache.begin(), cache.end(), index) == cache.end()) {
+            misses++;
+            cache.push_back(index);
+            if (cache.size() > CACHE_SIZE) {
+                cache.pop_front();
+            }
+        }
+    }
+
+    return static_cast<float>(misses) / (m_Indices.size() / 3);
+}
+
+float zephyr::rendering::MeshOptimizer::Overdraw() const {
+    if (m_Indices.size() < 3) {
+        return 0.0f;
+    }
+
+    glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+    for (const auto& vertex : m_Vertices) {
+        min = glm::min(min, vertex.Position);
+        max = glm::max(max, vertex.Position);
+    }
+    const glm::vec3 extent = glm::max(max - min, glm::vec3(1e-6f));
+
+    std::vector<float> depth(OVERDRAW_GRID * OVERDRAW_GRID);
+    std::vector<bool> covered(depth.size());
+    std::size_t shaded = 0, covered_count = 0;
+
+    // Orthographic views along both directions of each axis, back faces culled
+    // Near side of the view has smaller depth, front faces have negative area in (u, v) plane
+    for (int axis = 0; axis < 3; axis++) {
+        for (float direction : { 1.0f, -1.0f }) {
+            std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::max());
+            std::fill(covered.begin(), covered.end(), false);
+
+            const int u_axis = (axis + 1) % 3;
+            const int v_axis = (axis + 2) % 3;
+            auto project = [&](const glm::vec3& position) {
+                return glm::vec3(
+                    (position[u_axis] - min[u_axis]) / extent[u_axis] * OVERDRAW_GRID,
+                    (position[v_axis] - min[v_axis]) / extent[v_axis] * OVERDRAW_GRID,
+                    direction * (position[axis] - min[axis]));
+            };
+
+            for (std::size_t t = 0; t + 2 < m_Indices.size(); t += 3) {
+                const glm::vec3 a = project(m_Vertices[m_Indices[t]].Position);
+                const glm::vec3 b = project(m_Vertices[m_Indices[t + 1]].Position);
+                const glm::vec3 c = project(m_Vertices[m_Indices[t + 2]].Position);
+
+                const float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+                if (area * direction >= 0.0f) {
+                    continue;
+                }
+
+                const int x0 = std::max(static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))), 0);
+                const int x1 = std::min(static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))), OVERDRAW_GRID - 1);
+                const int y0 = std::max(static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))), 0);
+                const int y1 = std::min(static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))), OVERDRAW_GRID - 1);
+
+                for (int y = y0; y <= y1; y++) {
+                    for (int x = x0; x <= x1; x++) {
+                        const float px = x + 0.5f, py = y + 0.5f;
+                        const float w0 = ((b.x - px) * (c.y - py) - (c.x - px) * (b.y - py)) / area;
+                        const float w1 = ((c.x - px) * (a.y - py) - (a.x - px) * (c.y - py)) / area;
+                        const float w2 = 1.0f - w0 - w1;
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                            continue;
+                        }
+
+                        const float z = w0 * a.z + w1 * b.z + w2 * c.z;
+                        float& pixel = depth[y * OVERDRAW_GRID + x];
+                        if (z < pixel) {
+                            pixel = z;
+                            shaded++;
+                        }
+
+                        if (!covered[y * OVERDRAW_GRID + x]) {
+                            covered[y * OVERDRAW_GRID + x] = true;
+                            covered_count++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return covered_count > 0 ? static_cast<float>(shaded) / covered_count : 0.0f;
+}
@@ -0,0 +1,70 @@
+#ifndef MeshOptimizer_h
+#define MeshOptimizer_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <cstddef>
+#include <vector>
+
+namespace zephyr::rendering {
+
+struct MeshVertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+
+    bool operator==(const MeshVertex& other) const {
+        return Position == other.Position && Normal == other.Normal && TexCoords == other.TexCoords;
+    }
+};
+
+// Import time reordering of indexed triangle lists
+// Stages are meant to run in declaration order, each keeps the result of previous ones mostly intact
+class MeshOptimizer {
+public:
+    static constexpr std::size_t CACHE_SIZE = 16;   // FIFO size used for statistics
+
+    // Indices have to form a triangle list
+    MeshOptimizer(std::vector<MeshVertex> vertices, std::vector<GLuint> indices);
+
+    MeshOptimizer() = delete;
+    MeshOptimizer(const MeshOptimizer&) = delete;
+    MeshOptimizer& operator=(const MeshOptimizer&) = delete;
+    MeshOptimizer(MeshOptimizer&&) = default;
+    MeshOptimizer& operator=(MeshOptimizer&&) = default;
+    ~MeshOptimizer() = default;
+
+    // Merges bitwise identical vertices
+    void Deduplicate();
+
+    // Triangle order for post transform cache, Forsyth's algorithm
+    void OptimizeVertexCache();
+
+    // Sorts cache friendly clusters of triangles so that outward facing ones are drawn first
+    void OptimizeOverdraw();
+
+    // Vertices in order of first use, unreferenced ones are dropped
+    void OptimizeVertexFetch();
+
+    // Average cache miss ratio, transformed vertices per triangle
+    float ACMR() const;
+
+    // Shaded pixels per covered pixel averaged over six axis aligned views
+    float Overdraw() const;
+
+    const std::vector<MeshVertex>& Vertices() const { return m_Vertices; }
+    const std::vector<GLuint>& Indices() const { return m_Indices; }
+    std::vector<MeshVertex> ReleaseVertices() { return std::move(m_Vertices); }
+    std::vector<GLuint> ReleaseIndices() { return std::move(m_Indices); }
+
+private:
+    std::vector<MeshVertex> m_Vertices;
+    std::vector<GLuint> m_Indices;
+};
+
+}
+
+#endif
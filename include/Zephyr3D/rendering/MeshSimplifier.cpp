@@ -0,0 +1,267 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+struct PositionHash {
+    std::size_t operator()(const glm::vec3& position) const {
+        std::uint32_t bits[3];
+        std::memcpy(bits, &position.x, sizeof(bits));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+    }
+};
+
+struct Collapse {
+    GLuint From;
+    GLuint To;
+    double Error;
+};
+
+std::uint64_t EdgeKey(GLuint a, GLuint b) {
+    return a < b ? (static_cast<std::uint64_t>(a) << 32 | b) : (static_cast<std::uint64_t>(b) << 32 | a);
+}
+
+}
+
+zephyr::rendering::MeshSimplifier::MeshSimplifier(const std::vector<MeshVertex>& vertices)
+    : m_Vertices(vertices)
+    , m_PositionIds(vertices.size()) {
+    std::unordered_map<glm::vec3, GLuint, PositionHash> positions;
+    positions.reserve(vertices.size());
+
+    glm::vec3 min(0.0f), max(0.0f);
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        m_PositionIds[i] = positions.try_emplace(vertices[i].Position, static_cast<GLuint>(i)).first->second;
+
+        min = i == 0 ? vertices[i].Position : glm::min(min, vertices[i].Position);
+        max = i == 0 ? vertices[i].Position : glm::max(max, vertices[i].Position);
+    }
+
+    m_Extent = glm::length(max - min);
+}
+
+std::vector<GLuint> zephyr::rendering::MeshSimplifier::Simplify(const std::vector<GLuint>& indices, std::size_t target_indices_count, float max_error, float& result_error) const {
+    result_error = 0.0f;
+    std::vector<GLuint> result(indices);
+
+    const std::size_t vertex_count = m_Vertices.size();
+
+    // Seams have several vertices at one position, borders have edges used by one triangle
+    std::vector<unsigned int> position_vertices(vertex_count, 0);
+    for (std::size_t i = 0; i < vertex_count; i++) {
+        position_vertices[m_PositionIds[i]]++;
+    }
+
+    std::unordered_map<std::uint64_t, unsigned int> edge_triangles;
+    for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+        for (int e = 0; e < 3; e++) {
+            edge_triangles[EdgeKey(m_PositionIds[result[i + e]], m_PositionIds[result[i + (e + 1) % 3]])]++;
+        }
+    }
+
+    std::vector<bool> border(vertex_count, false);
+    for (const auto& [edge, count] : edge_triangles) {
+        if (count == 1) {
+            border[edge >> 32] = border[edge & 0xFFFFFFFF] = true;
+        }
+    }
+
+    std::vector<bool> locked(vertex_count, false);
+    for (std::size_t i = 0; i < vertex_count; i++) {
+        locked[i] = position_vertices[m_PositionIds[i]] > 1 || border[m_PositionIds[i]];
+    }
+
+    // Area weighted planes of adjacent triangles
+    std::vector<Quadric> quadrics(vertex_count);
+    for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+        const glm::vec3& p0 = m_Vertices[result[i]].Position;
+        const glm::vec3& p1 = m_Vertices[result[i + 1]].Position;
+        const glm::vec3& p2 = m_Vertices[result[i + 2]].Position;
+
+        const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(cross);
+        if (length <= 0.0f) {
+            continue;
+        }
+
+        const glm::vec3 normal = cross / length;
+        const Quadric plane = Quadric::Plane(normal, -glm::dot(normal, p0), length * 0.5f);
+        for (int v = 0; v < 3; v++) {
+            quadrics[result[i + v]] += plane;
+        }
+    }
+
+    const double max_error_squared = static_cast<double>(max_error) * max_error;
+    double accepted_error = 0.0;
+
+    std::vector<GLuint> remap(vertex_count);
+    std::vector<bool> touched(vertex_count);
+    std::vector<std::size_t> adjacency_offsets(vertex_count + 1);
+    std::vector<GLuint> adjacency;
+    std::vector<Collapse> collapses;
+
+    // Every pass collapses an independent set of edges in order of increasing error
+    while (result.size() > target_indices_count) {
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+        for (auto index : result) {
+            adjacency_offsets[index + 1]++;
+        }
+        for (std::size_t i = 0; i < vertex_count; i++) {
+            adjacency_offsets[i + 1] += adjacency_offsets[i];
+        }
+
+        adjacency.resize(result.size());
+        std::vector<std::size_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (std::size_t i = 0; i < result.size(); i++) {
+            adjacency[fill[result[i]]++] = static_cast<GLuint>(i / 3);
+        }
+
+        collapses.clear();
+        for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                const GLuint a = result[i + e];
+                const GLuint b = result[i + (e + 1) % 3];
+
+                for (auto [from, to] : { std::pair(a, b), std::pair(b, a) }) {
+                    if (locked[from]) {
+                        continue;
+                    }
+
+                    Quadric quadric = quadrics[from];
+                    quadric += quadrics[to];
+                    const double error = quadric.Error(m_Vertices[to].Position);
+                    if (error <= max_error_squared) {
+                        collapses.push_back({ from, to, error });
+                    }
+                }
+            }
+        }
+
+        if (collapses.empty()) {
+            break;
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.Error < rhs.Error; });
+
+        for (std::size_t i = 0; i < vertex_count; i++) {
+            remap[i] = static_cast<GLuint>(i);
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        const std::size_t triangles_to_remove = (result.size() - target_indices_count + 2) / 3;
+        std::size_t removed = 0;
+        std::size_t performed = 0;
+
+        for (const auto& [from, to, error] : collapses) {
+            if (removed >= triangles_to_remove) {
+                break;
+            }
+
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            // Reject collapses flipping any remaining triangle
+            bool valid = true;
+            std::size_t collapsed_triangles = 0;
+            for (std::size_t a = adjacency_offsets[from]; a < adjacency_offsets[from + 1] && valid; a++) {
+                const GLuint* triangle = &result[adjacency[a] * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                    collapsed_triangles++;
+                    continue;
+                }
+
+                glm::vec3 positions[3];
+                for (int v = 0; v < 3; v++) {
+                    positions[v] = m_Vertices[triangle[v]].Position;
+                }
+                const glm::vec3 before = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+
+                for (int v = 0; v < 3; v++) {
+                    if (triangle[v] == from) {
+                        positions[v] = m_Vertices[to].Position;
+                    }
+                }
+                const glm::vec3 after = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+
+                valid = glm::dot(before, after) > 0.0f;
+            }
+
+            if (!valid) {
+                continue;
+            }
+
+            // Neighbours of both ends are frozen for the rest of the pass
+            for (GLuint vertex : { from, to }) {
+                for (std::size_t a = adjacency_offsets[vertex]; a < adjacency_offsets[vertex + 1]; a++) {
+                    const GLuint* triangle = &result[adjacency[a] * 3];
+                    touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+                }
+            }
+
+            remap[from] = to;
+            quadrics[to] += quadrics[from];
+            accepted_error = std::max(accepted_error, error);
+            removed += collapsed_triangles;
+            performed++;
+        }
+
+        if (performed == 0) {
+            break;
+        }
+
+        // Drop triangles which became degenerate
+        std::size_t write = 0;
+        for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+            const GLuint a = remap[result[i]];
+            const GLuint b = remap[result[i + 1]];
+            const GLuint c = remap[result[i + 2]];
+            if (a != b && b != c && a != c) {
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    result_error = static_cast<float>(std::sqrt(accepted_error));
+    return result;
+}
+
+zephyr::rendering::MeshSimplifier::Quadric& zephyr::rendering::MeshSimplifier::Quadric::operator+=(const Quadric& other) {
+    A2 += other.A2; AB += other.AB; AC += other.AC; AD += other.AD;
+    B2 += other.B2; BC += other.BC; BD += other.BD;
+    C2 += other.C2; CD += other.CD;
+    D2 += other.D2;
+    Weight += other.Weight;
+
+    return *this;
+}
+
+double zephyr::rendering::MeshSimplifier::Quadric::Error(const glm::vec3& point) const {
+    const double x = point.x, y = point.y, z = point.z;
+    const double error = A2 * x * x + 2 * AB * x * y + 2 * AC * x * z + 2 * AD * x
+        + B2 * y * y + 2 * BC * y * z + 2 * BD * y
+        + C2 * z * z + 2 * CD * z
+        + D2;
+
+    return Weight > 0.0 ? std::max(error / Weight, 0.0) : 0.0;
+}
+
+zephyr::rendering::MeshSimplifier::Quadric zephyr::rendering::MeshSimplifier::Quadric::Plane(const glm::vec3& normal, float distance, float weight) {
+    const double a = normal.x, b = normal.y, c = normal.z, d = distance;
+
+    Quadric quadric;
+    quadric.A2 = weight * a * a; quadric.AB = weight * a * b; quadric.AC = weight * a * c; quadric.AD = weight * a * d;
+    quadric.B2 = weight * b * b; quadric.BC = weight * b * c; quadric.BD = weight * b * d;
+    quadric.C2 = weight * c * c; quadric.CD = weight * c * d;
+    quadric.D2 = weight * d * d;
+    quadric.Weight = weight;
+
+    return quadric;
+}
@@ -0,0 +1,53 @@
+#ifndef MeshSimplifier_h
+#define MeshSimplifier_h
+
+#include "MeshOptimizer.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace zephyr::rendering {
+
+// Quadric error metric simplification by collapsing vertices onto their neighbours
+// Vertex buffer is never modified, simplified index lists reference the same vertices,
+// so every level of detail shares one vertex buffer. Vertices on UV seams, hard edges
+// and open borders are locked in place.
+class MeshSimplifier {
+public:
+    explicit MeshSimplifier(const std::vector<MeshVertex>& vertices);
+
+    MeshSimplifier() = delete;
+    MeshSimplifier(const MeshSimplifier&) = delete;
+    MeshSimplifier& operator=(const MeshSimplifier&) = delete;
+    MeshSimplifier(MeshSimplifier&&) = delete;
+    MeshSimplifier& operator=(MeshSimplifier&&) = delete;
+    ~MeshSimplifier() = default;
+
+    // Stops at target count or when collapse would move surface further than max error
+    // Error is in vertex space units, the largest one accepted is written to result error
+    std::vector<GLuint> Simplify(const std::vector<GLuint>& indices, std::size_t target_indices_count, float max_error, float& result_error) const;
+
+    // Diagonal of vertex bounds
+    float Extent() const { return m_Extent; }
+
+private:
+    struct Quadric {
+        double A2{ 0 }, AB{ 0 }, AC{ 0 }, AD{ 0 };
+        double B2{ 0 }, BC{ 0 }, BD{ 0 };
+        double C2{ 0 }, CD{ 0 };
+        double D2{ 0 };
+        double Weight{ 0 };     // Error is normalized to squared distance
+
+        Quadric& operator+=(const Quadric& other);
+        double Error(const glm::vec3& point) const;
+        static Quadric Plane(const glm::vec3& normal, float distance, float weight);
+    };
+
+    const std::vector<MeshVertex>& m_Vertices;
+    std::vector<GLuint> m_PositionIds;      // First vertex sharing the position
+    float m_Extent{ 0.0f };
+};
+
+}
+
+#endif
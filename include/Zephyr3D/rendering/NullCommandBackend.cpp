@@ -0,0 +1,30 @@
+#include "NullCommandBackend.h"
+#include "RenderStats.h"
+
+void zephyr::rendering::NullCommandBackend::Execute(const CommandList& commands) {
+    auto& stats = RenderStats::Frame();
+
+    for (const auto& command : commands.Commands()) {
+        switch (command.Type) {
+        case ECommand::DrawArrays:
+        case ECommand::DrawElements:
+            stats.Draw(command.Target, command.Count);
+            break;
+
+        case ECommand::DrawArraysInstanced:
+        case ECommand::DrawElementsInstanced:
+        case ECommand::DrawElementsInstancedBaseVertex:
+            stats.DrawInstanced(command.Target, command.Count, command.Instances);
+            break;
+
+        case ECommand::MultiDrawElementsIndirect:
+            stats.MultiDraw(command.Count);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    m_Commands.insert(m_Commands.end(), commands.Commands().begin(), commands.Commands().end());
+}
@@ -0,0 +1,33 @@
+#ifndef NullCommandBackend_h
+#define NullCommandBackend_h
+
+#include "ICommandBackend.h"
+#include "CommandList.h"
+
+#include <vector>
+
+namespace zephyr::rendering {
+
+// Keeps replayed commands instead of issuing them
+// Lets recorded frames be inspected on machines without GL context, draws still count in RenderStats
+class NullCommandBackend : public ICommandBackend {
+public:
+    NullCommandBackend() = default;
+    NullCommandBackend(const NullCommandBackend&) = delete;
+    NullCommandBackend& operator=(const NullCommandBackend&) = delete;
+    NullCommandBackend(NullCommandBackend&&) = delete;
+    NullCommandBackend& operator=(NullCommandBackend&&) = delete;
+    ~NullCommandBackend() = default;
+
+    void Execute(const CommandList& commands) override;
+
+    const std::vector<Command>& Commands() const { return m_Commands; }
+    void Clear() { m_Commands.clear(); }
+
+private:
+    std::vector<Command> m_Commands;
+};
+
+}
+
+#endif
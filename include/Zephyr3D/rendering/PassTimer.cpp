@@ -0,0 +1,75 @@
+#include "PassTimer.h"
+
+#include <algorithm>
+#include <assert.h>
+
+zephyr::rendering::PassTimer::PassTimer() {
+    for (auto& frame : m_Frames) {
+        glGenQueries(static_cast<GLsizei>(MAX_PASSES), frame.Queries.data());
+        frame.Passes.reserve(MAX_PASSES);
+    }
+}
+
+zephyr::rendering::PassTimer::~PassTimer() {
+    for (auto& frame : m_Frames) {
+        glDeleteQueries(static_cast<GLsizei>(MAX_PASSES), frame.Queries.data());
+    }
+}
+
+void zephyr::rendering::PassTimer::Begin(const std::string& name) {
+    assert(!m_InPass);
+
+    Frame& frame = m_Frames[m_Current];
+    frame.Passes.push_back({ name, 0.0f, -1.0f });
+
+    // Passes over the limit get CPU time only
+    if (frame.Passes.size() <= MAX_PASSES) {
+        glBeginQuery(GL_TIME_ELAPSED, frame.Queries[frame.Passes.size() - 1]);
+    }
+
+    m_InPass = true;
+    m_PassStart = Clock::now();
+}
+
+void zephyr::rendering::PassTimer::End() {
+    assert(m_InPass);
+
+    Frame& frame = m_Frames[m_Current];
+    frame.Passes.back().CPU = std::chrono::duration<float, std::milli>(Clock::now() - m_PassStart).count();
+
+    if (frame.Passes.size() <= MAX_PASSES) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+
+    m_InPass = false;
+}
+
+void zephyr::rendering::PassTimer::EndFrame() {
+    assert(!m_InPass);
+
+    // Oldest frame in the ring is reused next, its queries had QUERY_FRAMES - 1 frames to finish
+    m_Current = (m_Current + 1) % QUERY_FRAMES;
+    Resolve(m_Frames[m_Current]);
+    m_Frames[m_Current].Passes.clear();
+}
+
+void zephyr::rendering::PassTimer::Resolve(Frame& frame) {
+    if (frame.Passes.empty()) {
+        return;
+    }
+
+    const std::size_t query_count = std::min(frame.Passes.size(), MAX_PASSES);
+    for (std::size_t i = 0; i < query_count; i++) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(frame.Queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        // Still in flight after whole ring, report it as unknown rather than stall
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &elapsed);
+            frame.Passes[i].GPU = static_cast<float>(elapsed) / 1000000.0f;
+        }
+    }
+
+    m_Timings = frame.Passes;
+}
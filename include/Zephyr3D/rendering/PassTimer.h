@@ -0,0 +1,65 @@
+#ifndef PassTimer_h
+#define PassTimer_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace zephyr::rendering {
+
+struct PassTiming {
+    std::string Name;
+    float CPU;  // Milliseconds
+    float GPU;  // Milliseconds, negative until the result arrives
+};
+
+// CPU and GPU time of render passes
+// GPU time is measured with GL_TIME_ELAPSED queries kept in a ring of QUERY_FRAMES frames.
+// Results are read right before their queries are reused, so published timings lag
+// QUERY_FRAMES - 1 frames behind and reading them never waits for the GPU.
+class PassTimer {
+public:
+    static constexpr std::size_t QUERY_FRAMES = 4;
+    static constexpr std::size_t MAX_PASSES = 16;
+
+    PassTimer();
+    PassTimer(const PassTimer&) = delete;
+    PassTimer& operator=(const PassTimer&) = delete;
+    PassTimer(PassTimer&&) = delete;
+    PassTimer& operator=(PassTimer&&) = delete;
+    ~PassTimer();
+
+    // Passes can't be nested, only one time elapsed query may be active
+    void Begin(const std::string& name);
+    void End();
+    void EndFrame();
+
+    const std::vector<PassTiming>& Timings() const { return m_Timings; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        std::array<GLuint, MAX_PASSES> Queries{};
+        std::vector<PassTiming> Passes;
+    };
+
+    void Resolve(Frame& frame);
+
+    std::array<Frame, QUERY_FRAMES> m_Frames;
+    std::size_t m_Current{ 0 };
+    Clock::time_point m_PassStart;
+    bool m_InPass{ false };
+
+    std::vector<PassTiming> m_Timings;
+};
+
+}
+
+#endif
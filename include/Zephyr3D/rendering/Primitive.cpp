@@ -1,4 +1,5 @@
 #include "Primitive.h"
+#include "StateCache.h"
 
 zephyr::rendering::Primitive::Primitive(const std::vector<GLfloat>& vertices, GLenum mode) 
     : m_Vertices(vertices)
@@ -111,30 +112,29 @@ GLuint zephyr::rendering::Primitive::VBO() const {
 }
 
 void zephyr::rendering::Primitive::Draw() const {
-    glBindVertexArray(m_VAO);
+    StateCache::Instance().BindVertexArray(m_VAO);
     glDrawArrays(m_Mode, 0, m_Count);
-    glBindVertexArray(0);
+    RenderStats::Frame().Draw(m_Mode, m_Count);
 }
 
 void zephyr::rendering::Primitive::DrawInstances(GLsizei count) const {
-    glBindVertexArray(m_VAO);
+    StateCache::Instance().BindVertexArray(m_VAO);
     glDrawArraysInstanced(m_Mode, 0, m_Count, count);
-    glBindVertexArray(0);
+    RenderStats::Frame().DrawInstanced(m_Mode, m_Count, count);
 }
 
 void zephyr::rendering::Primitive::Generate() {
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
 
-    glBindVertexArray(m_VAO);
+    StateCache::Instance().BindVertexArray(m_VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, m_VBO);
     glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(GLfloat), &m_Vertices[0], GL_STATIC_DRAW);
 
     // Position
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    StateCache::Instance().BindVertexArray(0);
 }
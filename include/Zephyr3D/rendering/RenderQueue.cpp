@@ -0,0 +1,96 @@
+#include "RenderQueue.h"
+#include "ShaderProgram.h"
+#include "CommandList.h"
+#include "../utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::uint64_t zephyr::rendering::RenderQueue::MakeKey(ERenderPass pass, GLuint shader, std::uint32_t material, GLuint vao, float depth) {
+    // Bits of positive float grow with its value, top half is precise enough for ordering
+    std::uint32_t depth_bits = 0;
+    depth = std::max(depth, 0.0f);
+    std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+    std::uint64_t depth_key = depth_bits >> 16;
+
+    // Transparent geometry is drawn back to front
+    if (pass == ERenderPass::Transparent) {
+        depth_key = ~depth_key & 0xFFFF;
+    }
+
+    return (static_cast<std::uint64_t>(pass) << 60)
+        | (static_cast<std::uint64_t>(shader & 0xFF) << 52)
+        | (static_cast<std::uint64_t>(material & 0xFFFFF) << 32)
+        | (static_cast<std::uint64_t>(vao & 0xFFFF) << 16)
+        | depth_key;
+}
+
+void zephyr::rendering::RenderQueue::Sort() {
+    const auto count = static_cast<std::uint32_t>(m_Packets.size());
+
+    m_Order.resize(count);
+    m_Scratch.resize(count);
+    for (std::uint32_t i = 0; i < count; i++) {
+        m_Order[i] = i;
+    }
+
+    // LSD radix sort over bytes of the key, stable between passes
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::uint32_t histogram[257] = { 0 };
+        for (std::uint32_t i = 0; i < count; i++) {
+            histogram[((m_Packets[i].Key >> shift) & 0xFF) + 1]++;
+        }
+
+        // All keys share this byte
+        if (count == 0 || histogram[((m_Packets[0].Key >> shift) & 0xFF) + 1] == count) {
+            continue;
+        }
+
+        for (int i = 1; i < 257; i++) {
+            histogram[i] += histogram[i - 1];
+        }
+
+        for (std::uint32_t i = 0; i < count; i++) {
+            const std::uint32_t index = m_Order[i];
+            m_Scratch[histogram[(m_Packets[index].Key >> shift) & 0xFF]++] = index;
+        }
+
+        m_Order.swap(m_Scratch);
+    }
+}
+
+void zephyr::rendering::RenderQueue::Record(std::vector<CommandList>& lists) const {
+    const std::size_t count = m_Order.size();
+    const std::size_t workers = std::clamp<std::size_t>(count / MIN_PACKETS_PER_LIST, 1, ThreadPool::Instance().Workers());
+    const std::size_t packets_per_worker = (count + workers - 1) / workers;
+    lists.resize(workers);
+
+    ThreadPool::Instance().Run(workers, [this, &lists, packets_per_worker, count](std::size_t worker) {
+        RecordRange(std::min(worker * packets_per_worker, count), std::min((worker + 1) * packets_per_worker, count), lists[worker]);
+    });
+}
+
+void zephyr::rendering::RenderQueue::RecordRange(std::size_t begin, std::size_t end, CommandList& commands) const {
+    commands.Clear();
+
+    const RenderPacket* previous = nullptr;
+    for (std::size_t i = begin; i < end; i++) {
+        const RenderPacket& packet = m_Packets[m_Order[i]];
+
+        if (previous && previous->Shader != packet.Shader) {
+            previous = nullptr;
+        }
+
+        if (!previous) {
+            commands.UseProgram(packet.Shader->ID());
+        }
+
+        packet.Shader->RecordPacket(packet, previous, commands);
+        previous = &packet;
+    }
+}
+
+void zephyr::rendering::RenderQueue::Clear() {
+    m_Packets.clear();
+    m_Order.clear();
+}
@@ -0,0 +1,74 @@
+#ifndef RenderQueue_h
+#define RenderQueue_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace zephyr::rendering {
+
+class ShaderProgram;
+class CommandList;
+
+enum class ERenderPass : std::uint64_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+struct RenderPacket {
+    std::uint64_t Key;
+    ShaderProgram* Shader;
+    const void* Drawable;   // Interpreted by the shader
+    const void* Material;   // Interpreted by the shader
+    glm::mat4 Model;
+};
+
+// Packets sorted by 64 bit keys, most significant fields first:
+// pass (4) | shader (8) | material (20) | vertex array (16) | depth (16)
+// Fields wider than their slot wrap around, shaders compare actual state before issuing calls.
+class RenderQueue {
+public:
+    static constexpr std::uint64_t PASS_MASK = 0xF000000000000000ull;
+    static constexpr std::uint64_t SHADER_MASK = 0x0FF0000000000000ull;
+    static constexpr std::uint64_t MATERIAL_MASK = 0x000FFFFF00000000ull;
+    static constexpr std::uint64_t VAO_MASK = 0x00000000FFFF0000ull;
+    static constexpr std::uint64_t DEPTH_MASK = 0x000000000000FFFFull;
+
+    // Packets recorded by one worker at least, smaller queues are recorded on the calling thread
+    static constexpr std::size_t MIN_PACKETS_PER_LIST = 256;
+
+    RenderQueue() = default;
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+    RenderQueue(RenderQueue&&) = delete;
+    RenderQueue& operator=(RenderQueue&&) = delete;
+    ~RenderQueue() = default;
+
+    static std::uint64_t MakeKey(ERenderPass pass, GLuint shader, std::uint32_t material, GLuint vao, float depth);
+
+    void Submit(const RenderPacket& packet) { m_Packets.push_back(packet); }
+    void Sort();
+    void Clear();
+
+    // Records sorted packets into one list per worker, lists have to be replayed in order
+    // Every list starts from unknown state, so it doesn't depend on the lists before it
+    void Record(std::vector<CommandList>& lists) const;
+
+    std::size_t Size() const { return m_Packets.size(); }
+
+private:
+    void RecordRange(std::size_t begin, std::size_t end, CommandList& commands) const;
+
+    std::vector<RenderPacket> m_Packets;
+    std::vector<std::uint32_t> m_Order;
+    std::vector<std::uint32_t> m_Scratch;
+};
+
+}
+
+#endif
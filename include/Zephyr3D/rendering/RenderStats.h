@@ -0,0 +1,86 @@
+#ifndef RenderStats_h
+#define RenderStats_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include <cstddef>
+
+namespace zephyr::rendering {
+
+// Counters of a single frame
+// Rendering code adds to Frame() while drawing, DrawManager publishes and resets them once frame ends
+struct RenderStats {
+    std::size_t DrawCalls{ 0 };
+    std::size_t InstancedDrawCalls{ 0 };
+    std::size_t MultiDrawCalls{ 0 };
+    std::size_t IndirectDraws{ 0 };
+    std::size_t Instances{ 0 };
+    std::size_t Triangles{ 0 };
+    std::size_t Vertices{ 0 };
+    std::size_t ProgramSwitches{ 0 };
+    std::size_t TextureBinds{ 0 };
+    std::size_t StateChanges{ 0 };
+    std::size_t ElidedStateChanges{ 0 };
+    std::size_t UploadedBytes{ 0 };
+    std::size_t DrawnObjects{ 0 };
+    std::size_t CulledObjects{ 0 };
+    std::size_t ExecutedPasses{ 0 };
+    std::size_t SkippedPasses{ 0 };
+
+    static RenderStats& Frame() {
+        static RenderStats frame;
+        return frame;
+    }
+
+    void Draw(GLenum mode, GLsizei count) {
+        DrawCalls++;
+        Instances++;
+        Primitives(mode, count, 1);
+    }
+
+    void DrawInstanced(GLenum mode, GLsizei count, GLsizei instances) {
+        DrawCalls++;
+        InstancedDrawCalls++;
+        Instances += instances;
+        Primitives(mode, count, instances);
+    }
+
+    // Parameters of indirect draws stay in GPU buffer, their issuer adds them with Indirect
+    void MultiDraw(GLsizei draws) {
+        DrawCalls++;
+        MultiDrawCalls++;
+        IndirectDraws += draws;
+    }
+
+    void Indirect(GLenum mode, GLsizei count, GLsizei instances) {
+        Instances += instances;
+        Primitives(mode, count, instances);
+    }
+
+    void Upload(std::size_t bytes) { UploadedBytes += bytes; }
+
+private:
+    void Primitives(GLenum mode, GLsizei count, GLsizei instances) {
+        Vertices += static_cast<std::size_t>(count) * instances;
+
+        switch (mode) {
+        case GL_TRIANGLES:
+            Triangles += static_cast<std::size_t>(count / 3) * instances;
+            break;
+
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+            Triangles += static_cast<std::size_t>(count > 2 ? count - 2 : 0) * instances;
+            break;
+
+        default:
+            break;
+        }
+    }
+};
+
+}
+
+#endif
@@ -1,76 +1,190 @@
 #include "ShaderProgram.h"
+#include "StateCache.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace {
+
+constexpr std::uint32_t PROGRAM_BINARY_MAGIC = 0x4E42505A; // "ZPBN"
+constexpr std::uint32_t PROGRAM_BINARY_VERSION = 1;
+
+struct ProgramBinaryHeader {
+    std::uint32_t Magic;
+    std::uint32_t Version;
+    std::uint64_t SourceHash;
+    std::uint64_t DriverHash;
+    std::uint32_t Format;
+    std::uint32_t Length;
+};
+
+// FNV-1a
+std::uint64_t Hash(const std::string& data, std::uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// Binaries are only valid for the driver that produced them
+std::uint64_t DriverHash() {
+    std::uint64_t hash = Hash("");
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const auto value = reinterpret_cast<const char*>(glGetString(name));
+        hash = Hash(value ? value : "", hash);
+    }
+
+    return hash;
+}
+
+}
 
 zephyr::rendering::ShaderProgram::ShaderProgram(const std::string& name, const std::string& vertex_path, const std::string& fragment_path, const std::string& geometry_path)
     : m_Name(name) {
     m_ID = glCreateProgram();
 
-    auto vertex_shader = CompileShader(vertex_path, GL_VERTEX_SHADER);
-    auto fragment_shader = CompileShader(fragment_path, GL_FRAGMENT_SHADER);
-    auto geometry_shader = !geometry_path.empty() ? CompileShader(geometry_path, GL_GEOMETRY_SHADER) : 0;
+    const std::string cache_path = SHADER_CACHE_PATH + name + ".bin";
+    const std::uint64_t source_hash = Hash(geometry_path, Hash(fragment_path, Hash(vertex_path)));
+    if (!LoadProgramBinary(cache_path, source_hash)) {
+        auto vertex_shader = CompileShader(vertex_path, GL_VERTEX_SHADER);
+        auto fragment_shader = CompileShader(fragment_path, GL_FRAGMENT_SHADER);
+        auto geometry_shader = !geometry_path.empty() ? CompileShader(geometry_path, GL_GEOMETRY_SHADER) : 0;
 
-    assert(vertex_shader != 0 && fragment_shader != 0);
+        assert(vertex_shader != 0 && fragment_shader != 0);
 
-    LinkProgram();
+        if (GLAD_GL_ARB_get_program_binary) {
+            glProgramParameteri(m_ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
+        if (LinkProgram()) {
+            SaveProgramBinary(cache_path, source_hash);
+        }
+
+        glDeleteShader(vertex_shader);
+        glDeleteShader(fragment_shader);
+        glDeleteShader(geometry_shader);
+    }
 
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-    glDeleteShader(geometry_shader);
+    ReflectUniforms();
+    BindUniformBlocks();
+}
+
+zephyr::rendering::ShaderProgram::ShaderProgram(const std::string& name)
+    : m_ID(0)
+    , m_Name(name) {
 }
 
 zephyr::rendering::ShaderProgram::~ShaderProgram() {
-    glDeleteProgram(m_ID);
+    if (m_ID != 0) {
+        StateCache::Instance().DeleteProgram(m_ID);
+    }
 }
 
 void zephyr::rendering::ShaderProgram::Use() const {
-    glUseProgram(m_ID);
+    StateCache::Instance().UseProgram(m_ID);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(m_ID, name.c_str()), (int)value);
+    glUniform1i(FindUniform(name).Location, (int)value);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1i(FindUniform(name).Location, value);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1f(FindUniform(name).Location, value);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::vec2 &vec) const {
-    glUniform2fv(glGetUniformLocation(m_ID, name.c_str()), 1, &vec[0]);
+    glUniform2fv(FindUniform(name).Location, 1, &vec[0]);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(m_ID, name.c_str()), x, y);
+    glUniform2f(FindUniform(name).Location, x, y);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::vec3 &vec) const {
-    glUniform3fv(glGetUniformLocation(m_ID, name.c_str()), 1, &vec[0]);
+    glUniform3fv(FindUniform(name).Location, 1, &vec[0]);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(m_ID, name.c_str()), x, y, z);
+    glUniform3f(FindUniform(name).Location, x, y, z);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::vec4 &vec) const {
-    glUniform4fv(glGetUniformLocation(m_ID, name.c_str()), 1, &vec[0]);
+    glUniform4fv(FindUniform(name).Location, 1, &vec[0]);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(m_ID, name.c_str()), x, y, z, w);
+    glUniform4f(FindUniform(name).Location, x, y, z, w);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::mat2 &mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(FindUniform(name).Location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::mat3 &mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(FindUniform(name).Location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void zephyr::rendering::ShaderProgram::Uniform(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(FindUniform(name).Location, 1, GL_FALSE, &mat[0][0]);
+}
+
+zephyr::rendering::UniformId zephyr::rendering::ShaderProgram::FindUniform(const std::string& name) const {
+    auto uniform = m_Uniforms.find(name);
+    return uniform != m_Uniforms.end() ? UniformId{ uniform->second } : UniformId{};
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, bool value) const {
+    glUniform1i(id.Location, (int)value);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, int value) const {
+    glUniform1i(id.Location, value);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, float value) const {
+    glUniform1f(id.Location, value);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::vec2 &vec) const {
+    glUniform2fv(id.Location, 1, &vec[0]);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, float x, float y) const {
+    glUniform2f(id.Location, x, y);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::vec3 &vec) const {
+    glUniform3fv(id.Location, 1, &vec[0]);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, float x, float y, float z) const {
+    glUniform3f(id.Location, x, y, z);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::vec4 &vec) const {
+    glUniform4fv(id.Location, 1, &vec[0]);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, float x, float y, float z, float w) const {
+    glUniform4f(id.Location, x, y, z, w);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::mat2 &mat) const {
+    glUniformMatrix2fv(id.Location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(id.Location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void zephyr::rendering::ShaderProgram::Uniform(UniformId id, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(id.Location, 1, GL_FALSE, &mat[0][0]);
 }
 
 std::string zephyr::rendering::ShaderProgram::ReadShaderFile(const std::string& path) {
@@ -115,7 +229,7 @@ GLuint zephyr::rendering::ShaderProgram::CompileShader(const std::string& code,
     return shader;
 }
 
-void zephyr::rendering::ShaderProgram::LinkProgram() {
+bool zephyr::rendering::ShaderProgram::LinkProgram() {
     glLinkProgram(m_ID);
     
     // Check linking errors
@@ -125,5 +239,136 @@ void zephyr::rendering::ShaderProgram::LinkProgram() {
     if (!success) {
         glGetProgramInfoLog(m_ID, infolog_max_length, nullptr, info_log);
         ERROR_LOG(Logger::ESender::Rendering, "Failed to link shader %d:\n%s", m_ID, info_log);
+        return false;
+    }
+
+    return true;
+}
+
+void zephyr::rendering::ShaderProgram::ReflectUniforms() {
+    GLint count = 0;
+    GLint max_length = 0;
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    std::vector<GLchar> buffer(std::max(max_length, 1));
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_ID, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+
+        std::string name(buffer.data(), length);
+
+        // Arrays of basic types are reported once as "name[0]", register every element
+        const auto bracket = name.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == name.size()) {
+            const std::string base = name.substr(0, bracket);
+            for (GLint element = 0; element < size; element++) {
+                const std::string element_name = base + '[' + std::to_string(element) + ']';
+                const GLint location = glGetUniformLocation(m_ID, element_name.c_str());
+                if (location != -1) {
+                    m_Uniforms.try_emplace(element_name, location);
+                }
+            }
+
+            name = base;
+        }
+
+        // Members of uniform blocks have no location
+        const GLint location = glGetUniformLocation(m_ID, name.c_str());
+        if (location != -1) {
+            m_Uniforms.try_emplace(name, location);
+        }
+    }
+}
+
+void zephyr::rendering::ShaderProgram::BindUniformBlocks() {
+    // Programs declaring shared blocks read them from common binding points
+    for (auto block : { EUniformBlock::Camera, EUniformBlock::Lights }) {
+        const GLuint index = glGetUniformBlockIndex(m_ID, UniformBuffer::BlockName(block));
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(m_ID, index, static_cast<GLuint>(block));
+        }
+    }
+}
+
+bool zephyr::rendering::ShaderProgram::LoadProgramBinary(const std::string& path, std::uint64_t source_hash) {
+    if (!GLAD_GL_ARB_get_program_binary) {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    ProgramBinaryHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.Magic != PROGRAM_BINARY_MAGIC || header.Version != PROGRAM_BINARY_VERSION) {
+        WARNING_LOG(Logger::ESender::Rendering, "Invalid program binary %s", path.c_str());
+        return false;
+    }
+
+    // Stale binaries are silently rebuilt
+    if (header.SourceHash != source_hash || header.DriverHash != DriverHash()) {
+        return false;
+    }
+
+    // Length of a corrupt header must not size the allocation, binary has to fill rest of the file
+    const std::streampos binary_begin = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff remaining = file.tellg() - binary_begin;
+    file.seekg(binary_begin);
+    if (header.Length == 0 || remaining != static_cast<std::streamoff>(header.Length)) {
+        WARNING_LOG(Logger::ESender::Rendering, "Truncated program binary %s", path.c_str());
+        return false;
+    }
+
+    std::vector<char> binary(header.Length);
+    file.read(binary.data(), binary.size());
+    if (!file) {
+        WARNING_LOG(Logger::ESender::Rendering, "Truncated program binary %s", path.c_str());
+        return false;
+    }
+
+    glProgramBinary(m_ID, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Driver is free to reject binary, source compilation follows then
+    GLint success;
+    glGetProgramiv(m_ID, GL_LINK_STATUS, &success);
+    if (!success) {
+        WARNING_LOG(Logger::ESender::Rendering, "Program binary %s rejected by the driver", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void zephyr::rendering::ShaderProgram::SaveProgramBinary(const std::string& path, std::uint64_t source_hash) const {
+    if (!GLAD_GL_ARB_get_program_binary) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(m_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(m_ID, length, nullptr, &format, binary.data());
+
+    ProgramBinaryHeader header{ PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, source_hash, DriverHash(), format, static_cast<std::uint32_t>(length) };
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), binary.size());
+    if (!file) {
+        WARNING_LOG(Logger::ESender::Rendering, "Failed to write program binary %s", path.c_str());
     }
 }
@@ -3,6 +3,9 @@
 
 #include "../debuging/Logger.h"
 #include "../core/Enum.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
+#include "CommandList.h"
 
 #pragma warning(push, 0)
 #include <glad/glad.h>
@@ -10,18 +13,26 @@
 #pragma warning(pop)
 
 #include <assert.h>
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 
 constexpr GLsizei infolog_max_length = 1024;
+constexpr const char* SHADER_CACHE_PATH = "shader_cache/";
 
 namespace zephyr::rendering {
 
 class ICamera;
 
+// Location of an active uniform resolved once after linking
+struct UniformId {
+    GLint Location{ -1 };
+};
+
 class ShaderProgram {
 public:
     ShaderProgram(const std::string& name, const std::string& vertex_code, const std::string& fragment_code, const std::string& geometry_code);
@@ -39,6 +50,15 @@ public:
 
     virtual void Draw(const ICamera* camera) = 0;
 
+    // Shaders without anything to draw are skipped by DrawManager, Use included
+    virtual bool HasWork() const { return true; }
+
+    // Deferred drawing through render queue, shaders drawing everything in Draw don't need it
+    // Packets are recorded on worker threads, RecordPacket may only read shader state
+    // previous is the packet recorded just before into the same list, null after shader switch
+    virtual void Submit(RenderQueue& /*queue*/, const ICamera* /*camera*/) {}
+    virtual void RecordPacket(const RenderPacket& /*packet*/, const RenderPacket* /*previous*/, CommandList& /*commands*/) const {}
+
     void Uniform(const std::string &name, bool value) const;
     void Uniform(const std::string &name, int value) const;
     void Uniform(const std::string &name, float value) const;
@@ -52,15 +72,40 @@ public:
     void Uniform(const std::string &name, const glm::mat3 &mat) const;
     void Uniform(const std::string &name, const glm::mat4 &mat) const;
 
+    UniformId FindUniform(const std::string& name) const;
+
+    void Uniform(UniformId id, bool value) const;
+    void Uniform(UniformId id, int value) const;
+    void Uniform(UniformId id, float value) const;
+    void Uniform(UniformId id, const glm::vec2 &vec) const;
+    void Uniform(UniformId id, float x, float y) const;
+    void Uniform(UniformId id, const glm::vec3 &vec) const;
+    void Uniform(UniformId id, float x, float y, float z) const;
+    void Uniform(UniformId id, const glm::vec4 &vec) const;
+    void Uniform(UniformId id, float x, float y, float z, float w) const;
+    void Uniform(UniformId id, const glm::mat2 &mat) const;
+    void Uniform(UniformId id, const glm::mat3 &mat) const;
+    void Uniform(UniformId id, const glm::mat4 &mat) const;
+
 protected:
+    // Program without GL object, for shaders which only record packets, e.g. in headless tests
+    explicit ShaderProgram(const std::string& name);
+
     std::string ReadShaderFile(const std::string& path);
 
 private:
     GLuint m_ID;
     std::string m_Name;
+    std::unordered_map<std::string, GLint> m_Uniforms;
 
-    void LinkProgram();
+    bool LinkProgram();
     GLuint CompileShader(const std::string& code, GLenum shader);
+    void ReflectUniforms();
+    void BindUniformBlocks();
+
+    // Program binary cache, keyed on sources and driver identity
+    bool LoadProgramBinary(const std::string& path, std::uint64_t source_hash);
+    void SaveProgramBinary(const std::string& path, std::uint64_t source_hash) const;
 };
 
 }
@@ -0,0 +1,238 @@
+#include "StateCache.h"
+
+#include <assert.h>
+
+void zephyr::rendering::StateCache::UseProgram(GLuint program) {
+    if (Changed(m_Program, program)) {
+        RenderStats::Frame().ProgramSwitches++;
+        glUseProgram(program);
+    }
+}
+
+void zephyr::rendering::StateCache::BindVertexArray(GLuint vao) {
+    if (Changed(m_VAO, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void zephyr::rendering::StateCache::BindBuffer(GLenum target, GLuint buffer) {
+    // Element array binding belongs to the vertex array, always pass it through
+    const int index = BufferTargetIndex(target);
+    if (index < 0) {
+        RenderStats::Frame().StateChanges++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (Changed(m_Buffers[index], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void zephyr::rendering::StateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // Indexed bindings are set up once, only the generic binding they also change is tracked
+    RenderStats::Frame().StateChanges++;
+    glBindBufferBase(target, index, buffer);
+
+    const int target_index = BufferTargetIndex(target);
+    if (target_index >= 0) {
+        m_Buffers[target_index] = buffer;
+    }
+}
+
+void zephyr::rendering::StateCache::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+    assert(unit < MAX_TEXTURE_UNITS);
+
+    const int index = TextureTargetIndex(target);
+    if (index < 0) {
+        RenderStats::Frame().StateChanges++;
+        RenderStats::Frame().TextureBinds++;
+        ActiveTexture(unit);
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (Changed(m_Textures[unit][index], texture)) {
+        RenderStats::Frame().TextureBinds++;
+        ActiveTexture(unit);
+        glBindTexture(target, texture);
+    }
+}
+
+void zephyr::rendering::StateCache::Enable(GLenum capability) {
+    Capability(capability, GL_TRUE);
+}
+
+void zephyr::rendering::StateCache::Disable(GLenum capability) {
+    Capability(capability, GL_FALSE);
+}
+
+void zephyr::rendering::StateCache::DepthFunc(GLenum func) {
+    if (Changed(m_DepthFunc, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void zephyr::rendering::StateCache::DepthMask(GLboolean mask) {
+    if (Changed(m_DepthMask, mask)) {
+        glDepthMask(mask);
+    }
+}
+
+void zephyr::rendering::StateCache::DeleteProgram(GLuint program) {
+    glDeleteProgram(program);
+
+    // Deletion of current program is deferred until another one is used
+    if (m_Program == program) {
+        m_Program = UNKNOWN;
+    }
+}
+
+void zephyr::rendering::StateCache::DeleteVertexArray(GLuint vao) {
+    glDeleteVertexArrays(1, &vao);
+
+    if (m_VAO == vao) {
+        m_VAO = 0;
+    }
+}
+
+void zephyr::rendering::StateCache::DeleteBuffer(GLuint buffer) {
+    glDeleteBuffers(1, &buffer);
+
+    for (auto& bound : m_Buffers) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+}
+
+void zephyr::rendering::StateCache::DeleteTexture(GLuint texture) {
+    glDeleteTextures(1, &texture);
+
+    for (auto& unit : m_Textures) {
+        for (auto& bound : unit) {
+            if (bound == texture) {
+                bound = 0;
+            }
+        }
+    }
+}
+
+void zephyr::rendering::StateCache::Invalidate() {
+    m_Program = UNKNOWN;
+    m_VAO = UNKNOWN;
+    m_Buffers.fill(UNKNOWN);
+    m_ActiveTexture = UNKNOWN;
+    for (auto& unit : m_Textures) {
+        unit.fill(UNKNOWN);
+    }
+    m_Capabilities.fill(UNKNOWN);
+    m_DepthFunc = UNKNOWN;
+    m_DepthMask = UNKNOWN;
+}
+
+int zephyr::rendering::StateCache::BufferTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return 0;
+
+    case GL_UNIFORM_BUFFER:
+        return 1;
+
+    case GL_TEXTURE_BUFFER:
+        return 2;
+
+    case GL_PIXEL_UNPACK_BUFFER:
+        return 3;
+
+    case GL_PIXEL_PACK_BUFFER:
+        return 4;
+
+    case GL_COPY_READ_BUFFER:
+        return 5;
+
+    case GL_COPY_WRITE_BUFFER:
+        return 6;
+
+    case GL_DRAW_INDIRECT_BUFFER:
+        return 7;
+
+    default:
+        return -1;
+    }
+}
+
+int zephyr::rendering::StateCache::TextureTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D:
+        return 0;
+
+    case GL_TEXTURE_CUBE_MAP:
+        return 1;
+
+    case GL_TEXTURE_BUFFER:
+        return 2;
+
+    default:
+        return -1;
+    }
+}
+
+int zephyr::rendering::StateCache::CapabilityIndex(GLenum capability) {
+    switch (capability) {
+    case GL_DEPTH_TEST:
+        return 0;
+
+    case GL_BLEND:
+        return 1;
+
+    case GL_CULL_FACE:
+        return 2;
+
+    case GL_SCISSOR_TEST:
+        return 3;
+
+    case GL_STENCIL_TEST:
+        return 4;
+
+    case GL_MULTISAMPLE:
+        return 5;
+
+    default:
+        return -1;
+    }
+}
+
+bool zephyr::rendering::StateCache::Changed(GLuint& cached, GLuint value) {
+    if (cached == value) {
+        RenderStats::Frame().ElidedStateChanges++;
+        return false;
+    }
+
+    cached = value;
+    RenderStats::Frame().StateChanges++;
+    return true;
+}
+
+void zephyr::rendering::StateCache::ActiveTexture(GLuint unit) {
+    if (Changed(m_ActiveTexture, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void zephyr::rendering::StateCache::Capability(GLenum capability, GLuint enabled) {
+    const int index = CapabilityIndex(capability);
+    if (index >= 0 && !Changed(m_Capabilities[index], enabled)) {
+        return;
+    }
+
+    if (index < 0) {
+        RenderStats::Frame().StateChanges++;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef StateCache_h
+#define StateCache_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include "RenderStats.h"
+
+#include <array>
+#include <cstddef>
+
+namespace zephyr::rendering {
+
+// Shadow copy of OpenGL bindings and capabilities
+// Rendering code changes state only through the cache, calls setting already current
+// values are skipped and counted in RenderStats. Unknown state is always issued, Invalidate
+// after foreign code touched GL.
+class StateCache {
+public:
+    static constexpr GLuint MAX_TEXTURE_UNITS = 16;
+
+    static StateCache& Instance() {
+        static StateCache instance;
+        return instance;
+    }
+
+    StateCache(const StateCache&) = delete;
+    StateCache& operator=(const StateCache&) = delete;
+    StateCache(StateCache&&) = delete;
+    StateCache& operator=(StateCache&&) = delete;
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    void DepthFunc(GLenum func);
+    void DepthMask(GLboolean mask);
+
+    // Deleted names are reused by the driver, bindings pointing at them fall back to 0
+    void DeleteProgram(GLuint program);
+    void DeleteVertexArray(GLuint vao);
+    void DeleteBuffer(GLuint buffer);
+    void DeleteTexture(GLuint texture);
+
+    void Invalidate();
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u;
+    static constexpr std::size_t BUFFER_TARGETS = 8;
+    static constexpr std::size_t TEXTURE_TARGETS = 3;
+    static constexpr std::size_t CAPABILITIES = 6;
+
+    StateCache() { Invalidate(); }
+    ~StateCache() = default;
+
+    static int BufferTargetIndex(GLenum target);
+    static int TextureTargetIndex(GLenum target);
+    static int CapabilityIndex(GLenum capability);
+
+    bool Changed(GLuint& cached, GLuint value);
+    void ActiveTexture(GLuint unit);
+    void Capability(GLenum capability, GLuint enabled);
+
+    GLuint m_Program;
+    GLuint m_VAO;
+    std::array<GLuint, BUFFER_TARGETS> m_Buffers;
+    GLuint m_ActiveTexture;
+    std::array<std::array<GLuint, TEXTURE_TARGETS>, MAX_TEXTURE_UNITS> m_Textures;
+    std::array<GLuint, CAPABILITIES> m_Capabilities;
+    GLuint m_DepthFunc;
+    GLuint m_DepthMask;
+};
+
+}
+
+#endif
@@ -1,57 +1,25 @@
 #include "Texture.h"
+#include "StateCache.h"
 
 
 zephyr::rendering::Texture::Texture(const resources::Image& raw_texture, Texture::EType type)
     : m_Type(type) {
-    const GLenum format = [&]() {
-        switch (raw_texture.Components()) {
-        case 1:
-            return GL_RED;
-
-        case 3:
-            return GL_RGB;
-
-        case 4:
-            return GL_RGBA;
-
-        default:
-            return -1;
-        }
-    }();
-
     glGenTextures(1, &m_ID);
-    glBindTexture(GL_TEXTURE_2D, m_ID);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_2D, m_ID);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, raw_texture.Width(), raw_texture.Height(), 0, format, GL_UNSIGNED_BYTE, raw_texture.Data());
-    glGenerateMipmap(GL_TEXTURE_2D);
+    m_Upload(raw_texture);
 }
 
 zephyr::rendering::Texture::Texture(const resources::Image& raw_texture, EType type, GLenum wrap_s, GLenum wrap_t, GLenum min_filter, GLenum mag_filter)
     : m_Type(type) {
-    const GLenum format = [&]() {
-        switch (raw_texture.Components()) {
-        case 1:
-            return GL_RED;
-
-        case 3:
-            return GL_RGB;
-
-        case 4:
-            return GL_RGBA;
-
-        default:
-            return -1;
-        }
-    }();
-
     glGenTextures(1, &m_ID);
-    glBindTexture(GL_TEXTURE_2D, m_ID);
+    StateCache::Instance().BindTexture(0, GL_TEXTURE_2D, m_ID);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t);
@@ -59,24 +27,92 @@ zephyr::rendering::Texture::Texture(const resources::Image& raw_texture, EType t
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, raw_texture.Width(), raw_texture.Height(), 0, format, GL_UNSIGNED_BYTE, raw_texture.Data());
-    glGenerateMipmap(GL_TEXTURE_2D);
+    m_Upload(raw_texture);
 }
 
 zephyr::rendering::Texture::Texture(Texture&& other) noexcept
     : m_ID(std::exchange(other.m_ID, 0))
-    , m_Type(other.m_Type) {
+    , m_Type(other.m_Type)
+    , m_Size(std::exchange(other.m_Size, 0)) {
 }
 
 zephyr::rendering::Texture& zephyr::rendering::Texture::operator=(Texture&& other) noexcept {
     m_ID = std::exchange(other.m_ID, 0);
     m_Type = other.m_Type;
+    m_Size = std::exchange(other.m_Size, 0);
 
     return *this;
 }
 
 zephyr::rendering::Texture::~Texture() {
-    glDeleteTextures(1, &m_ID);
+    StateCache::Instance().DeleteTexture(m_ID);
+}
+
+void zephyr::rendering::Texture::m_Upload(const resources::Image& raw_texture) {
+    if (raw_texture.Compression() == resources::Image::ECompression::None) {
+        const GLenum format = [&]() {
+            switch (raw_texture.Components()) {
+            case 1:
+                return GL_RED;
+
+            case 3:
+                return GL_RGB;
+
+            case 4:
+                return GL_RGBA;
+
+            default:
+                return -1;
+            }
+        }();
+
+        glTexImage2D(GL_TEXTURE_2D, 0, format, raw_texture.Width(), raw_texture.Height(), 0, format, GL_UNSIGNED_BYTE, raw_texture.Data());
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        // Full mip chain adds a third of the base level
+        const std::size_t base_size = static_cast<std::size_t>(raw_texture.Width()) * raw_texture.Height() * raw_texture.Components();
+        m_Size = base_size + base_size / 3;
+        RenderStats::Frame().Upload(base_size);
+        return;
+    }
+
+    // Cooked textures come with precomputed mip chain, upload blocks as they are
+    const GLenum internal_format = CompressedFormat(raw_texture.Compression());
+    const auto& levels = raw_texture.Levels();
+    for (size_t i = 0; i < levels.size(); i++) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), internal_format, levels[i].Width, levels[i].Height, 0, static_cast<GLsizei>(levels[i].Size), raw_texture.Data() + levels[i].Offset);
+        m_Size += levels[i].Size;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+    RenderStats::Frame().Upload(m_Size);
+}
+
+GLenum zephyr::rendering::Texture::CompressedFormat(resources::Image::ECompression compression) {
+    switch (compression) {
+    case resources::Image::ECompression::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    case resources::Image::ECompression::BC2:
+        return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+
+    case resources::Image::ECompression::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+    case resources::Image::ECompression::BC4:
+        return GL_COMPRESSED_RED_RGTC1;
+
+    case resources::Image::ECompression::BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+
+    case resources::Image::ECompression::BC7:
+        if (!GLAD_GL_ARB_texture_compression_bptc) {
+            ERROR_LOG(Logger::ESender::Rendering, "BC7 textures are not supported by the driver");
+        }
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+
+    default: // resources::Image::ECompression::None
+        return 0;
+    }
 }
 
 std::string zephyr::rendering::Texture::TypeName() const {
@@ -41,9 +41,17 @@ public:
     EType Type() const { return m_Type; }
     std::string TypeName() const;
 
+    // Estimated video memory taken by all levels in bytes
+    std::size_t Size() const { return m_Size; }
+
+    static GLenum CompressedFormat(resources::Image::ECompression compression);
+
 private:
     GLuint m_ID;
     EType m_Type;
+    std::size_t m_Size{ 0 };
+
+    void m_Upload(const resources::Image& raw_texture);
 };
 
 }
@@ -0,0 +1,38 @@
+#include "UniformBuffer.h"
+#include "StateCache.h"
+
+#include <assert.h>
+
+zephyr::rendering::UniformBuffer::UniformBuffer(EUniformBlock block, std::size_t size)
+    : m_Size(size) {
+    glGenBuffers(1, &m_ID);
+    StateCache::Instance().BindBuffer(GL_UNIFORM_BUFFER, m_ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+
+    StateCache::Instance().BindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(block), m_ID);
+}
+
+zephyr::rendering::UniformBuffer::~UniformBuffer() {
+    StateCache::Instance().DeleteBuffer(m_ID);
+}
+
+void zephyr::rendering::UniformBuffer::Update(const void* data, std::size_t size, std::size_t offset) const {
+    assert(offset + size <= m_Size);
+
+    StateCache::Instance().BindBuffer(GL_UNIFORM_BUFFER, m_ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    RenderStats::Frame().Upload(size);
+}
+
+const char* zephyr::rendering::UniformBuffer::BlockName(EUniformBlock block) {
+    switch (block) {
+    case EUniformBlock::Camera:
+        return "Camera";
+
+    case EUniformBlock::Lights:
+        return "Lights";
+
+    default:
+        return "";
+    }
+}
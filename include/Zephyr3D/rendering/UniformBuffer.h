@@ -0,0 +1,44 @@
+#ifndef UniformBuffer_h
+#define UniformBuffer_h
+
+#pragma warning(push, 0)
+#include <glad/glad.h>
+#pragma warning(pop)
+
+#include <cstddef>
+
+namespace zephyr::rendering {
+
+// Binding points of uniform blocks shared between shader programs
+enum class EUniformBlock : GLuint {
+    Camera = 0,
+    Lights = 1
+};
+
+class UniformBuffer {
+public:
+    UniformBuffer(EUniformBlock block, std::size_t size);
+
+    UniformBuffer() = delete;
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+    UniformBuffer(UniformBuffer&&) = delete;
+    UniformBuffer& operator=(UniformBuffer&&) = delete;
+    ~UniformBuffer();
+
+    GLuint ID() const { return m_ID; }
+    std::size_t Size() const { return m_Size; }
+
+    void Update(const void* data, std::size_t size, std::size_t offset = 0) const;
+
+    // Name of the block in GLSL sources
+    static const char* BlockName(EUniformBlock block);
+
+private:
+    GLuint m_ID;
+    std::size_t m_Size;
+};
+
+}
+
+#endif
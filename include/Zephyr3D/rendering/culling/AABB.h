@@ -0,0 +1,72 @@
+#ifndef AABB_h
+#define AABB_h
+
+#pragma warning(push, 0)
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <limits>
+
+namespace zephyr::rendering {
+
+// Axis aligned bounding box, empty when Min > Max
+struct AABB {
+    glm::vec3 Min{ std::numeric_limits<float>::max() };
+    glm::vec3 Max{ std::numeric_limits<float>::lowest() };
+
+    bool Empty() const { return Min.x > Max.x || Min.y > Max.y || Min.z > Max.z; }
+    glm::vec3 Center() const { return (Min + Max) * 0.5f; }
+    glm::vec3 Extents() const { return (Max - Min) * 0.5f; }
+
+    float SurfaceArea() const {
+        const glm::vec3 size = Max - Min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void Expand(const glm::vec3& point) {
+        Min = glm::min(Min, point);
+        Max = glm::max(Max, point);
+    }
+
+    void Expand(const AABB& other) {
+        Min = glm::min(Min, other.Min);
+        Max = glm::max(Max, other.Max);
+    }
+
+    bool Contains(const AABB& other) const {
+        return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z
+            && Max.x >= other.Max.x && Max.y >= other.Max.y && Max.z >= other.Max.z;
+    }
+
+    bool Overlaps(const AABB& other) const {
+        return Min.x <= other.Max.x && Min.y <= other.Max.y && Min.z <= other.Max.z
+            && Max.x >= other.Min.x && Max.y >= other.Min.y && Max.z >= other.Min.z;
+    }
+
+    static AABB Merge(const AABB& a, const AABB& b) {
+        return AABB{ glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+    }
+
+    // Box enclosing transformed box (Arvo)
+    static AABB Transform(const AABB& box, const glm::mat4& matrix) {
+        if (box.Empty()) {
+            return box;
+        }
+
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(box.Center(), 1.0f));
+        const glm::vec3 extents = box.Extents();
+
+        glm::vec3 new_extents(0.0f);
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                new_extents[row] += glm::abs(matrix[column][row]) * extents[column];
+            }
+        }
+
+        return AABB{ center - new_extents, center + new_extents };
+    }
+};
+
+}
+
+#endif
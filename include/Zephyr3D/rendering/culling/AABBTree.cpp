@@ -0,0 +1,231 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+#include <assert.h>
+
+zephyr::rendering::AABBTree::AABBTree(float margin)
+    : m_Margin(margin) {
+}
+
+int zephyr::rendering::AABBTree::Insert(const AABB& box, void* user_data) {
+    const int proxy = AllocateNode();
+
+    Node& node = m_Nodes[proxy];
+    node.Bounds = AABB{ box.Min - glm::vec3(m_Margin), box.Max + glm::vec3(m_Margin) };
+    node.UserData = user_data;
+    node.Height = 0;
+
+    InsertLeaf(proxy);
+    m_LeafCount++;
+
+    return proxy;
+}
+
+void zephyr::rendering::AABBTree::Remove(int proxy) {
+    assert(proxy >= 0 && proxy < static_cast<int>(m_Nodes.size()) && m_Nodes[proxy].Leaf());
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_LeafCount--;
+}
+
+bool zephyr::rendering::AABBTree::Move(int proxy, const AABB& box) {
+    assert(proxy >= 0 && proxy < static_cast<int>(m_Nodes.size()) && m_Nodes[proxy].Leaf());
+
+    if (m_Nodes[proxy].Bounds.Contains(box)) {
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+    m_Nodes[proxy].Bounds = AABB{ box.Min - glm::vec3(m_Margin), box.Max + glm::vec3(m_Margin) };
+    InsertLeaf(proxy);
+
+    return true;
+}
+
+int zephyr::rendering::AABBTree::AllocateNode() {
+    if (m_FreeList == NULL_NODE) {
+        m_Nodes.emplace_back();
+        return static_cast<int>(m_Nodes.size()) - 1;
+    }
+
+    const int node = m_FreeList;
+    m_FreeList = m_Nodes[node].Parent;
+    m_Nodes[node] = Node();
+
+    return node;
+}
+
+void zephyr::rendering::AABBTree::FreeNode(int node) {
+    m_Nodes[node].Parent = m_FreeList;
+    m_Nodes[node].Height = -1;
+    m_FreeList = node;
+}
+
+void zephyr::rendering::AABBTree::InsertLeaf(int leaf) {
+    if (m_Root == NULL_NODE) {
+        m_Root = leaf;
+        m_Nodes[leaf].Parent = NULL_NODE;
+        return;
+    }
+
+    // Descend choosing child with the lowest surface area increase
+    const AABB leaf_bounds = m_Nodes[leaf].Bounds;
+    int index = m_Root;
+    while (!m_Nodes[index].Leaf()) {
+        const Node& node = m_Nodes[index];
+
+        const float area = node.Bounds.SurfaceArea();
+        const float combined_area = AABB::Merge(node.Bounds, leaf_bounds).SurfaceArea();
+
+        // Cost of creating new parent here and minimum cost of pushing the leaf further down
+        const float cost = 2.0f * combined_area;
+        const float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto child_cost = [&](int child) {
+            const AABB merged = AABB::Merge(m_Nodes[child].Bounds, leaf_bounds);
+            const float merged_area = merged.SurfaceArea();
+            return m_Nodes[child].Leaf() ? merged_area + inheritance_cost : merged_area - m_Nodes[child].Bounds.SurfaceArea() + inheritance_cost;
+        };
+
+        const float left_cost = child_cost(node.Left);
+        const float right_cost = child_cost(node.Right);
+
+        if (cost < left_cost && cost < right_cost) {
+            break;
+        }
+
+        index = left_cost < right_cost ? node.Left : node.Right;
+    }
+
+    // Replace sibling with new parent of both
+    const int sibling = index;
+    const int old_parent = m_Nodes[sibling].Parent;
+    const int new_parent = AllocateNode();
+
+    m_Nodes[new_parent].Parent = old_parent;
+    m_Nodes[new_parent].Bounds = AABB::Merge(leaf_bounds, m_Nodes[sibling].Bounds);
+    m_Nodes[new_parent].Height = m_Nodes[sibling].Height + 1;
+    m_Nodes[new_parent].Left = sibling;
+    m_Nodes[new_parent].Right = leaf;
+    m_Nodes[sibling].Parent = new_parent;
+    m_Nodes[leaf].Parent = new_parent;
+
+    if (old_parent == NULL_NODE) {
+        m_Root = new_parent;
+    } else if (m_Nodes[old_parent].Left == sibling) {
+        m_Nodes[old_parent].Left = new_parent;
+    } else {
+        m_Nodes[old_parent].Right = new_parent;
+    }
+
+    // Refit ancestors
+    index = m_Nodes[leaf].Parent;
+    while (index != NULL_NODE) {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        node.Height = 1 + std::max(m_Nodes[node.Left].Height, m_Nodes[node.Right].Height);
+        node.Bounds = AABB::Merge(m_Nodes[node.Left].Bounds, m_Nodes[node.Right].Bounds);
+
+        index = node.Parent;
+    }
+}
+
+void zephyr::rendering::AABBTree::RemoveLeaf(int leaf) {
+    if (leaf == m_Root) {
+        m_Root = NULL_NODE;
+        return;
+    }
+
+    const int parent = m_Nodes[leaf].Parent;
+    const int grand_parent = m_Nodes[parent].Parent;
+    const int sibling = m_Nodes[parent].Left == leaf ? m_Nodes[parent].Right : m_Nodes[parent].Left;
+
+    if (grand_parent == NULL_NODE) {
+        m_Root = sibling;
+        m_Nodes[sibling].Parent = NULL_NODE;
+        FreeNode(parent);
+        return;
+    }
+
+    // Sibling takes place of the parent
+    if (m_Nodes[grand_parent].Left == parent) {
+        m_Nodes[grand_parent].Left = sibling;
+    } else {
+        m_Nodes[grand_parent].Right = sibling;
+    }
+    m_Nodes[sibling].Parent = grand_parent;
+    FreeNode(parent);
+
+    int index = grand_parent;
+    while (index != NULL_NODE) {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        node.Bounds = AABB::Merge(m_Nodes[node.Left].Bounds, m_Nodes[node.Right].Bounds);
+        node.Height = 1 + std::max(m_Nodes[node.Left].Height, m_Nodes[node.Right].Height);
+
+        index = node.Parent;
+    }
+}
+
+int zephyr::rendering::AABBTree::Balance(int a) {
+    // Rotate higher grandchild up when subtrees heights differ by more than one
+    Node& A = m_Nodes[a];
+    if (A.Leaf() || A.Height < 2) {
+        return a;
+    }
+
+    const int b = A.Left;
+    const int c = A.Right;
+    const int balance = m_Nodes[c].Height - m_Nodes[b].Height;
+
+    auto rotate = [&](int up) {
+        // Child of a becomes its parent
+        Node& U = m_Nodes[up];
+        const int f = U.Left;
+        const int g = U.Right;
+
+        U.Left = a;
+        U.Parent = A.Parent;
+        A.Parent = up;
+
+        if (U.Parent == NULL_NODE) {
+            m_Root = up;
+        } else if (m_Nodes[U.Parent].Left == a) {
+            m_Nodes[U.Parent].Left = up;
+        } else {
+            m_Nodes[U.Parent].Right = up;
+        }
+
+        // Higher grandchild stays under up, the other goes to a
+        const int stay = m_Nodes[f].Height > m_Nodes[g].Height ? f : g;
+        const int move = stay == f ? g : f;
+
+        U.Right = stay;
+        if (A.Left == up) {
+            A.Left = move;
+        } else {
+            A.Right = move;
+        }
+        m_Nodes[move].Parent = a;
+
+        A.Bounds = AABB::Merge(m_Nodes[A.Left].Bounds, m_Nodes[A.Right].Bounds);
+        A.Height = 1 + std::max(m_Nodes[A.Left].Height, m_Nodes[A.Right].Height);
+        U.Bounds = AABB::Merge(m_Nodes[U.Left].Bounds, m_Nodes[U.Right].Bounds);
+        U.Height = 1 + std::max(m_Nodes[U.Left].Height, m_Nodes[U.Right].Height);
+
+        return up;
+    };
+
+    if (balance > 1) {
+        return rotate(c);
+    }
+
+    if (balance < -1) {
+        return rotate(b);
+    }
+
+    return a;
+}
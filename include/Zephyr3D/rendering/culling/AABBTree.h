@@ -0,0 +1,129 @@
+#ifndef AABBTree_h
+#define AABBTree_h
+
+#include "AABB.h"
+#include "Frustum.h"
+
+#include <vector>
+
+namespace zephyr::rendering {
+
+// Dynamic bounding volume hierarchy
+// Leaves store boxes fattened by a margin, so small movements don't restructure the tree.
+class AABBTree {
+public:
+    static constexpr int NULL_NODE = -1;
+
+    explicit AABBTree(float margin = 0.1f);
+
+    AABBTree(const AABBTree&) = delete;
+    AABBTree& operator=(const AABBTree&) = delete;
+    AABBTree(AABBTree&&) = default;
+    AABBTree& operator=(AABBTree&&) = default;
+    ~AABBTree() = default;
+
+    int Insert(const AABB& box, void* user_data);
+    void Remove(int proxy);
+
+    // Returns true when the leaf had to be reinserted
+    bool Move(int proxy, const AABB& box);
+
+    void* UserData(int proxy) const { return m_Nodes[proxy].UserData; }
+    const AABB& FatBounds(int proxy) const { return m_Nodes[proxy].Bounds; }
+
+    template <class Callback>
+    void Query(const Frustum& frustum, Callback callback) const;
+
+    template <class Callback>
+    void Query(const AABB& box, Callback callback) const;
+
+    int Height() const { return m_Root != NULL_NODE ? m_Nodes[m_Root].Height : 0; }
+    std::size_t Count() const { return m_LeafCount; }
+
+private:
+    struct Node {
+        AABB Bounds;
+        void* UserData{ nullptr };
+        int Parent{ NULL_NODE };    // Next free node when unused
+        int Left{ NULL_NODE };
+        int Right{ NULL_NODE };
+        int Height{ 0 };            // -1 when unused
+
+        bool Leaf() const { return Left == NULL_NODE; }
+    };
+
+    std::vector<Node> m_Nodes;
+    int m_Root{ NULL_NODE };
+    int m_FreeList{ NULL_NODE };
+    std::size_t m_LeafCount{ 0 };
+    float m_Margin;
+
+    int AllocateNode();
+    void FreeNode(int node);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int node);
+};
+
+template <class Callback>
+void AABBTree::Query(const Frustum& frustum, Callback callback) const {
+    if (m_Root == NULL_NODE) {
+        return;
+    }
+
+    // Second element tells whether the node is known to be fully inside
+    std::vector<std::pair<int, bool>> stack;
+    stack.emplace_back(m_Root, false);
+
+    while (!stack.empty()) {
+        const auto [index, inside] = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_Nodes[index];
+        Frustum::EResult result = Frustum::EResult::Inside;
+        if (!inside) {
+            result = frustum.Test(node.Bounds);
+            if (result == Frustum::EResult::Outside) {
+                continue;
+            }
+        }
+
+        if (node.Leaf()) {
+            callback(node.UserData);
+        } else {
+            const bool children_inside = result == Frustum::EResult::Inside;
+            stack.emplace_back(node.Left, children_inside);
+            stack.emplace_back(node.Right, children_inside);
+        }
+    }
+}
+
+template <class Callback>
+void AABBTree::Query(const AABB& box, Callback callback) const {
+    if (m_Root == NULL_NODE) {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(m_Root);
+
+    while (!stack.empty()) {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        if (!node.Bounds.Overlaps(box)) {
+            continue;
+        }
+
+        if (node.Leaf()) {
+            callback(node.UserData);
+        } else {
+            stack.push_back(node.Left);
+            stack.push_back(node.Right);
+        }
+    }
+}
+
+}
+
+#endif
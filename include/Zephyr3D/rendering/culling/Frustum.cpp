@@ -0,0 +1,43 @@
+#include "Frustum.h"
+
+zephyr::rendering::Frustum::Frustum(const glm::mat4& projection_view) {
+    const glm::vec4 row_x(projection_view[0][0], projection_view[1][0], projection_view[2][0], projection_view[3][0]);
+    const glm::vec4 row_y(projection_view[0][1], projection_view[1][1], projection_view[2][1], projection_view[3][1]);
+    const glm::vec4 row_z(projection_view[0][2], projection_view[1][2], projection_view[2][2], projection_view[3][2]);
+    const glm::vec4 row_w(projection_view[0][3], projection_view[1][3], projection_view[2][3], projection_view[3][3]);
+
+    // Gribb-Hartmann: left, right, bottom, top, near, far
+    m_Planes = {
+        row_w + row_x,
+        row_w - row_x,
+        row_w + row_y,
+        row_w - row_y,
+        row_w + row_z,
+        row_w - row_z
+    };
+
+    for (auto& plane : m_Planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+zephyr::rendering::Frustum::EResult zephyr::rendering::Frustum::Test(const AABB& box) const {
+    EResult result = EResult::Inside;
+
+    for (const auto& plane : m_Planes) {
+        const glm::vec3 normal(plane);
+
+        // Corner furthest along the normal
+        const glm::vec3 positive(normal.x >= 0.0f ? box.Max.x : box.Min.x, normal.y >= 0.0f ? box.Max.y : box.Min.y, normal.z >= 0.0f ? box.Max.z : box.Min.z);
+        if (glm::dot(normal, positive) + plane.w < 0.0f) {
+            return EResult::Outside;
+        }
+
+        const glm::vec3 negative(normal.x >= 0.0f ? box.Min.x : box.Max.x, normal.y >= 0.0f ? box.Min.y : box.Max.y, normal.z >= 0.0f ? box.Min.z : box.Max.z);
+        if (glm::dot(normal, negative) + plane.w < 0.0f) {
+            result = EResult::Intersects;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef Frustum_h
+#define Frustum_h
+
+#include "AABB.h"
+
+#pragma warning(push, 0)
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <array>
+
+namespace zephyr::rendering {
+
+class Frustum {
+public:
+    enum class EResult {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    // Planes extracted from projection * view matrix, normals point inside
+    explicit Frustum(const glm::mat4& projection_view);
+
+    EResult Test(const AABB& box) const;
+    bool Visible(const AABB& box) const { return Test(box) != EResult::Outside; }
+
+    const std::array<glm::vec4, 6>& Planes() const { return m_Planes; }
+
+private:
+    std::array<glm::vec4, 6> m_Planes;
+};
+
+}
+
+#endif
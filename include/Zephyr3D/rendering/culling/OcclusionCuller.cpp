@@ -0,0 +1,269 @@
+#include "OcclusionCuller.h"
+#include "../../utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZEPHYR_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float MIN_W = 1e-4f;
+
+}
+
+zephyr::rendering::OcclusionCuller::OcclusionCuller(int width, int height)
+    : m_Width(width)
+    , m_Height(height)
+    , m_TilesX((width + TILE_SIZE - 1) / TILE_SIZE)
+    , m_TilesY((height + TILE_SIZE - 1) / TILE_SIZE) {
+    m_Bins.resize(static_cast<std::size_t>(m_TilesX) * m_TilesY);
+
+    int level_width = width;
+    int level_height = height;
+    while (true) {
+        m_LevelSizes.emplace_back(level_width, level_height);
+        m_Pyramid.emplace_back(static_cast<std::size_t>(level_width) * level_height, 1.0f);
+
+        if (level_width == 1 && level_height == 1) {
+            break;
+        }
+
+        level_width = std::max(level_width / 2, 1);
+        level_height = std::max(level_height / 2, 1);
+    }
+}
+
+void zephyr::rendering::OcclusionCuller::Begin(const glm::mat4& projection_view) {
+    m_ProjectionView = projection_view;
+    m_Triangles.clear();
+
+    for (auto& bin : m_Bins) {
+        bin.clear();
+    }
+
+    std::fill(m_Pyramid[0].begin(), m_Pyramid[0].end(), 1.0f);
+}
+
+void zephyr::rendering::OcclusionCuller::AddOccluder(const std::vector<glm::vec3>& positions, const std::vector<std::uint32_t>& indices, const glm::mat4& model) {
+    const glm::mat4 mvp = m_ProjectionView * model;
+
+    std::vector<glm::vec4> clip(positions.size());
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        clip[i] = mvp * glm::vec4(positions[i], 1.0f);
+    }
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::vec4* vertices[3] = { &clip[indices[i]], &clip[indices[i + 1]], &clip[indices[i + 2]] };
+
+        // Triangles crossing near plane are dropped, occluding less is always safe
+        if (vertices[0]->w < MIN_W || vertices[1]->w < MIN_W || vertices[2]->w < MIN_W) {
+            continue;
+        }
+
+        glm::vec3 screen[3];
+        for (int v = 0; v < 3; v++) {
+            const glm::vec3 ndc = glm::vec3(*vertices[v]) / vertices[v]->w;
+            screen[v] = glm::vec3((ndc.x * 0.5f + 0.5f) * m_Width, (ndc.y * 0.5f + 0.5f) * m_Height, ndc.z * 0.5f + 0.5f);
+        }
+
+        // Occluders are treated as double sided
+        const float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+        if (area == 0.0f) {
+            continue;
+        }
+        if (area < 0.0f) {
+            std::swap(screen[1], screen[2]);
+        }
+
+        const float min_x = std::min({ screen[0].x, screen[1].x, screen[2].x });
+        const float max_x = std::max({ screen[0].x, screen[1].x, screen[2].x });
+        const float min_y = std::min({ screen[0].y, screen[1].y, screen[2].y });
+        const float max_y = std::max({ screen[0].y, screen[1].y, screen[2].y });
+        if (max_x < 0.0f || max_y < 0.0f || min_x >= m_Width || min_y >= m_Height) {
+            continue;
+        }
+
+        const auto index = static_cast<std::uint32_t>(m_Triangles.size());
+        m_Triangles.push_back({ screen[0], screen[1], screen[2] });
+
+        // Bin into overlapped tiles
+        const int tile_x0 = std::max(static_cast<int>(min_x) / TILE_SIZE, 0);
+        const int tile_x1 = std::min(static_cast<int>(max_x) / TILE_SIZE, m_TilesX - 1);
+        const int tile_y0 = std::max(static_cast<int>(min_y) / TILE_SIZE, 0);
+        const int tile_y1 = std::min(static_cast<int>(max_y) / TILE_SIZE, m_TilesY - 1);
+        for (int y = tile_y0; y <= tile_y1; y++) {
+            for (int x = tile_x0; x <= tile_x1; x++) {
+                m_Bins[y * m_TilesX + x].push_back(index);
+            }
+        }
+    }
+}
+
+void zephyr::rendering::OcclusionCuller::Rasterize() {
+    const int tile_count = m_TilesX * m_TilesY;
+    const int workers = std::clamp(static_cast<int>(ThreadPool::Instance().Workers()), 1, tile_count);
+
+    // Tiles don't share pixels, each worker takes every n-th tile
+    if (workers > 1 && m_Triangles.size() > 64) {
+        ThreadPool::Instance().Run(workers, [this, workers, tile_count](std::size_t worker) {
+            for (int tile = static_cast<int>(worker); tile < tile_count; tile += workers) {
+                RasterizeTile(tile);
+            }
+        });
+    } else {
+        for (int tile = 0; tile < tile_count; tile++) {
+            RasterizeTile(tile);
+        }
+    }
+
+    BuildPyramid();
+}
+
+bool zephyr::rendering::OcclusionCuller::Visible(const AABB& box) const {
+    if (m_Triangles.empty() || box.Empty()) {
+        return true;
+    }
+
+    float min_x = std::numeric_limits<float>::max(), max_x = std::numeric_limits<float>::lowest();
+    float min_y = std::numeric_limits<float>::max(), max_y = std::numeric_limits<float>::lowest();
+    float min_z = std::numeric_limits<float>::max();
+
+    for (int i = 0; i < 8; i++) {
+        const glm::vec3 corner(i & 1 ? box.Max.x : box.Min.x, i & 2 ? box.Max.y : box.Min.y, i & 4 ? box.Max.z : box.Min.z);
+        const glm::vec4 clip = m_ProjectionView * glm::vec4(corner, 1.0f);
+        if (clip.w < MIN_W) {
+            return true;
+        }
+
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        min_x = std::min(min_x, (ndc.x * 0.5f + 0.5f) * m_Width);
+        max_x = std::max(max_x, (ndc.x * 0.5f + 0.5f) * m_Width);
+        min_y = std::min(min_y, (ndc.y * 0.5f + 0.5f) * m_Height);
+        max_y = std::max(max_y, (ndc.y * 0.5f + 0.5f) * m_Height);
+        min_z = std::min(min_z, ndc.z * 0.5f + 0.5f);
+    }
+
+    const int x0 = std::clamp(static_cast<int>(std::floor(min_x)), 0, m_Width - 1);
+    const int x1 = std::clamp(static_cast<int>(std::floor(max_x)), 0, m_Width - 1);
+    const int y0 = std::clamp(static_cast<int>(std::floor(min_y)), 0, m_Height - 1);
+    const int y1 = std::clamp(static_cast<int>(std::floor(max_y)), 0, m_Height - 1);
+
+    // Coarsest level where the rectangle spans at most two texels per axis
+    int level = 0;
+    while (level + 1 < static_cast<int>(m_Pyramid.size()) && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    const auto& depth = m_Pyramid[level];
+    const glm::ivec2 size = m_LevelSizes[level];
+    for (int y = std::min(y0 >> level, size.y - 1); y <= std::min(y1 >> level, size.y - 1); y++) {
+        for (int x = std::min(x0 >> level, size.x - 1); x <= std::min(x1 >> level, size.x - 1); x++) {
+            if (min_z <= depth[y * size.x + x]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void zephyr::rendering::OcclusionCuller::RasterizeTile(int tile) {
+    const int min_x = (tile % m_TilesX) * TILE_SIZE;
+    const int min_y = (tile / m_TilesX) * TILE_SIZE;
+    const int max_x = std::min(min_x + TILE_SIZE, m_Width) - 1;
+    const int max_y = std::min(min_y + TILE_SIZE, m_Height) - 1;
+
+    for (auto index : m_Bins[tile]) {
+        RasterizeTriangle(m_Triangles[index], min_x, min_y, max_x, max_y);
+    }
+}
+
+void zephyr::rendering::OcclusionCuller::RasterizeTriangle(const Triangle& triangle, int min_x, int min_y, int max_x, int max_y) {
+    const glm::vec3& v0 = triangle.V0;
+    const glm::vec3& v1 = triangle.V1;
+    const glm::vec3& v2 = triangle.V2;
+
+    const int x0 = std::max(min_x, static_cast<int>(std::floor(std::min({ v0.x, v1.x, v2.x }))));
+    const int x1 = std::min(max_x, static_cast<int>(std::ceil(std::max({ v0.x, v1.x, v2.x }))));
+    const int y0 = std::max(min_y, static_cast<int>(std::floor(std::min({ v0.y, v1.y, v2.y }))));
+    const int y1 = std::min(max_y, static_cast<int>(std::ceil(std::max({ v0.y, v1.y, v2.y }))));
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    // Edge functions E(x, y) = A * x + B * y + C, positive inside
+    const float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0 = v1.x * v2.y - v2.x * v1.y;
+    const float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1 = v2.x * v0.y - v0.x * v2.y;
+    const float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2 = v0.x * v1.y - v1.x * v0.y;
+    const float area = c0 + c1 + c2;
+
+    // Depth plane z = dzdx * x + dzdy * y + z0
+    const float dzdx = (a0 * v0.z + a1 * v1.z + a2 * v2.z) / area;
+    const float dzdy = (b0 * v0.z + b1 * v1.z + b2 * v2.z) / area;
+    const float z0 = (c0 * v0.z + c1 * v1.z + c2 * v2.z) / area;
+
+    float* depth = m_Pyramid[0].data();
+
+    for (int y = y0; y <= y1; y++) {
+        const float py = y + 0.5f;
+        int x = x0;
+
+#ifdef ZEPHYR_OCCLUSION_SSE
+        // Four pixels at once
+        const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        for (; x + 3 <= x1; x += 4) {
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+            const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), _mm_set1_ps(b0 * py + c0));
+            const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), _mm_set1_ps(b1 * py + c1));
+            const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), _mm_set1_ps(b2 * py + c2));
+            const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            const __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), _mm_set1_ps(dzdy * py + z0));
+            float* row = depth + y * m_Width + x;
+            const __m128 old_z = _mm_loadu_ps(row);
+            const __m128 new_z = _mm_min_ps(old_z, z);
+            _mm_storeu_ps(row, _mm_or_ps(_mm_and_ps(inside, new_z), _mm_andnot_ps(inside, old_z)));
+        }
+#endif
+
+        for (; x <= x1; x++) {
+            const float px = x + 0.5f;
+            if (a0 * px + b0 * py + c0 < 0.0f || a1 * px + b1 * py + c1 < 0.0f || a2 * px + b2 * py + c2 < 0.0f) {
+                continue;
+            }
+
+            float& pixel = depth[y * m_Width + x];
+            pixel = std::min(pixel, dzdx * px + dzdy * py + z0);
+        }
+    }
+}
+
+void zephyr::rendering::OcclusionCuller::BuildPyramid() {
+    for (std::size_t level = 1; level < m_Pyramid.size(); level++) {
+        const glm::ivec2 source_size = m_LevelSizes[level - 1];
+        const glm::ivec2 size = m_LevelSizes[level];
+        const auto& source = m_Pyramid[level - 1];
+        auto& destination = m_Pyramid[level];
+
+        // Farthest depth of 2x2 block, odd edges are clamped
+        for (int y = 0; y < size.y; y++) {
+            const int sy0 = std::min(y * 2, source_size.y - 1);
+            const int sy1 = std::min(y * 2 + 1, source_size.y - 1);
+            for (int x = 0; x < size.x; x++) {
+                const int sx0 = std::min(x * 2, source_size.x - 1);
+                const int sx1 = std::min(x * 2 + 1, source_size.x - 1);
+                destination[y * size.x + x] = std::max({ source[sy0 * source_size.x + sx0], source[sy0 * source_size.x + sx1], source[sy1 * source_size.x + sx0], source[sy1 * source_size.x + sx1] });
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef OcclusionCuller_h
+#define OcclusionCuller_h
+
+#include "AABB.h"
+
+#pragma warning(push, 0)
+#include <glm/glm.hpp>
+#pragma warning(pop)
+
+#include <cstdint>
+#include <vector>
+
+namespace zephyr::rendering {
+
+// Software rasterizer of occluder meshes into low resolution depth buffer
+// Depth is stored in [0, 1] range with 0 at near plane. Hierarchical Z pyramid keeps
+// the farthest depth of each 2x2 block, so boxes are tested with a few texel reads.
+class OcclusionCuller {
+public:
+    static constexpr int TILE_SIZE = 32;
+
+    OcclusionCuller(int width = 256, int height = 128);
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+    OcclusionCuller(OcclusionCuller&&) = default;
+    OcclusionCuller& operator=(OcclusionCuller&&) = default;
+    ~OcclusionCuller() = default;
+
+    // Clears depth buffer and drops occluders from previous frame
+    void Begin(const glm::mat4& projection_view);
+
+    void AddOccluder(const std::vector<glm::vec3>& positions, const std::vector<std::uint32_t>& indices, const glm::mat4& model);
+
+    // Rasterizes occluders in parallel tiles and builds depth pyramid
+    void Rasterize();
+
+    // Conservative, boxes crossing near plane are always visible
+    bool Visible(const AABB& box) const;
+
+    int Width() const { return m_Width; }
+    int Height() const { return m_Height; }
+    std::size_t OccluderTriangles() const { return m_Triangles.size(); }
+    const std::vector<float>& Depth(int level = 0) const { return m_Pyramid[level]; }
+
+private:
+    // Screen space triangle, counter clockwise
+    struct Triangle {
+        glm::vec3 V0, V1, V2;
+    };
+
+    int m_Width;
+    int m_Height;
+    int m_TilesX;
+    int m_TilesY;
+    glm::mat4 m_ProjectionView{ 1.0f };
+
+    std::vector<Triangle> m_Triangles;
+    std::vector<std::vector<std::uint32_t>> m_Bins;     // Triangles overlapping each tile
+    std::vector<std::vector<float>> m_Pyramid;          // Level 0 is the depth buffer
+    std::vector<glm::ivec2> m_LevelSizes;
+
+    void RasterizeTile(int tile);
+    void RasterizeTriangle(const Triangle& triangle, int min_x, int min_y, int max_x, int max_y);
+    void BuildPyramid();
+};
+
+}
+
+#endif
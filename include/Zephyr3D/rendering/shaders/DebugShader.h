@@ -3,6 +3,7 @@
 
 #include "../ShaderProgram.h"
 #include "../Primitive.h"
+#include "../StateCache.h"
 
 #pragma warning(push, 0)
 #define GLM_ENABLE_EXPERIMENTAL
@@ -15,6 +16,9 @@
 #include <glm/gtx/norm.hpp>
 #pragma warning(pop)
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <tuple>
 
@@ -34,22 +38,56 @@ public:
         , m_TrianglePrefab(Primitive::Triangle())
         , m_PlanePrefab(Primitive::Plane())
         , m_CubePrefab(Primitive::Cube()) {
+        SetupStream(m_LinePrefab.VAO(), m_Lines);
+        SetupStream(m_TrianglePrefab.VAO(), m_Triangles);
+        SetupStream(m_PlanePrefab.VAO(), m_Planes);
+        SetupStream(m_CubePrefab.VAO(), m_Cuboids);
+        SetupStream(m_LineVertices, GL_LINES);
+        SetupStream(m_TriangleVertices, GL_TRIANGLES);
     }
 
     Debug(const Debug&) = delete;
     Debug& operator=(const Debug&) = delete;
     Debug(Debug&&) = delete;
     Debug& operator=(Debug&&) = delete;
-    ~Debug() = default;
+    ~Debug() {
+        for (auto stream : { &m_Lines, &m_Triangles, &m_Planes, &m_Cuboids }) {
+            StateCache::Instance().DeleteBuffer(stream->Buffer);
+        }
+
+        for (auto stream : { &m_LineVertices, &m_TriangleVertices }) {
+            StateCache::Instance().DeleteVertexArray(stream->VAO);
+            StateCache::Instance().DeleteBuffer(stream->Buffer);
+        }
+    }
+
+    bool HasWork() const override {
+        return !m_Lines.Instances.empty() || !m_Triangles.Instances.empty() || !m_Planes.Instances.empty() || !m_Cuboids.Instances.empty()
+            || !m_LineVertices.Vertices.empty() || !m_TriangleVertices.Vertices.empty();
+    }
 
     void Draw(const ICamera* camera) override {
-        glm::mat4 pv = camera->Projection() * camera->View();
-        Uniform("pv", pv);
+        DrawStream(m_LinePrefab, m_Lines);
+        DrawStream(m_TrianglePrefab, m_Triangles);
+        DrawStream(m_PlanePrefab, m_Planes);
+        DrawStream(m_CubePrefab, m_Cuboids);
+        DrawStream(m_LineVertices);
+        DrawStream(m_TriangleVertices);
+    }
 
-        DrawLines();
-        DrawTriangles();
-        DrawPlanes();
-        DrawCubes();
+    // World space vertices streamed as they are, for large amounts of primitives like physics debug
+    // Costs 16 bytes per vertex instead of a model matrix and color per primitive
+    void StreamLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color) {
+        const std::uint32_t packed = PackColor(color);
+        m_LineVertices.Vertices.push_back({ start, packed });
+        m_LineVertices.Vertices.push_back({ end, packed });
+    }
+
+    void StreamTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& color) {
+        const std::uint32_t packed = PackColor(color);
+        m_TriangleVertices.Vertices.push_back({ v0, packed });
+        m_TriangleVertices.Vertices.push_back({ v1, packed });
+        m_TriangleVertices.Vertices.push_back({ v2, packed });
     }
 
     void DrawLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color) {
@@ -72,7 +110,7 @@ public:
         model *= rotation;
         model = glm::scale(model, glm::vec3(length));
 
-        m_Lines.emplace_back(model, color);
+        m_Lines.Instances.emplace_back(model, color);
     }
 
     void DrawTriangle(const glm::vec3& upper, const glm::vec3& lower_left, const glm::vec3& lower_right, const glm::vec3& color) {
@@ -97,7 +135,7 @@ public:
             0.0f, 0.0f, 0.0f, 0.0f
         ));
 
-        m_Triangles.emplace_back(lhs * rhs, color);
+        m_Triangles.Instances.emplace_back(lhs * rhs, color);
     }
 
     void DrawPlane(const glm::vec3& position, const glm::vec3& normal, float constant, const glm::vec3& color) {
@@ -107,16 +145,37 @@ public:
         transform = transform * glm::toMat4(glm::quat(normal, plane_normal));
         transform = glm::scale(transform, glm::vec3(constant));
 
-        m_Planes.emplace_back(transform, color);
+        m_Planes.Instances.emplace_back(transform, color);
     }
 
     void DrawCube(const glm::mat4& transform, const glm::vec3& color) {
-        m_Cuboids.emplace_back(transform, color);
+        m_Cuboids.Instances.emplace_back(transform, color);
     }
 
 private:
     const static GLsizei s_ElementSize = sizeof(instance_data::value_type);
 
+    // Instance buffer kept between frames, reallocated only when it has to grow
+    struct InstanceStream {
+        instance_data Instances;
+        GLuint Buffer{ 0 };
+        std::size_t Capacity{ 0 };
+    };
+
+    struct Vertex {
+        glm::vec3 Position;
+        std::uint32_t Color;    // RGBA8
+    };
+
+    // Vertex buffer with its own vertex array, drawn with a single non instanced call
+    struct VertexStream {
+        std::vector<Vertex> Vertices;
+        GLuint VAO{ 0 };
+        GLuint Buffer{ 0 };
+        std::size_t Capacity{ 0 };
+        GLenum Mode{ GL_LINES };
+    };
+
     // Prefabs
     Primitive m_LinePrefab;
     Primitive m_TrianglePrefab;
@@ -124,59 +183,92 @@ private:
     Primitive m_CubePrefab;
 
     //
-    instance_data m_Lines;
-    instance_data m_Triangles;
-    instance_data m_Planes;
-    instance_data m_Cuboids;
-
-    void DrawLines() {
-        GLuint buffer = PrepareBuffer(m_LinePrefab.VAO(), m_Lines);
-        m_LinePrefab.DrawInstances(static_cast<GLsizei>(m_Lines.size()));
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glDeleteBuffers(1, &buffer);
-        m_Lines.clear();
+    InstanceStream m_Lines;
+    InstanceStream m_Triangles;
+    InstanceStream m_Planes;
+    InstanceStream m_Cuboids;
+
+    VertexStream m_LineVertices;
+    VertexStream m_TriangleVertices;
+
+    void DrawStream(const Primitive& prefab, InstanceStream& stream) {
+        if (stream.Instances.empty()) {
+            return;
+        }
+
+        StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, stream.Buffer);
+        if (stream.Instances.size() > stream.Capacity) {
+            stream.Capacity = std::max(stream.Instances.size(), stream.Capacity * 2);
+        }
+
+        // Orphan previous storage so the driver doesn't wait for last frame draw
+        glBufferData(GL_ARRAY_BUFFER, s_ElementSize * stream.Capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, s_ElementSize * stream.Instances.size(), stream.Instances.data());
+        RenderStats::Frame().Upload(s_ElementSize * stream.Instances.size());
+
+        prefab.DrawInstances(static_cast<GLsizei>(stream.Instances.size()));
+        stream.Instances.clear();
     }
 
-    void DrawTriangles() {
-        GLuint buffer = PrepareBuffer(m_TrianglePrefab.VAO(), m_Triangles);
-        m_TrianglePrefab.DrawInstances(static_cast<GLsizei>(m_Triangles.size()));
+    void DrawStream(VertexStream& stream) {
+        if (stream.Vertices.empty()) {
+            return;
+        }
+
+        StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, stream.Buffer);
+        if (stream.Vertices.size() > stream.Capacity) {
+            stream.Capacity = std::max(stream.Vertices.size(), stream.Capacity * 2);
+        }
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glDeleteBuffers(1, &buffer);
-        m_Triangles.clear();
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * stream.Capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * stream.Vertices.size(), stream.Vertices.data());
+        RenderStats::Frame().Upload(sizeof(Vertex) * stream.Vertices.size());
+
+        // Vertices are in world space, model is constant identity
+        // Constant attribute values aren't part of vertex array state, set them before every draw
+        StateCache::Instance().BindVertexArray(stream.VAO);
+        for (GLuint i = 0; i < 4; i++) {
+            const glm::vec4 column(i == 0, i == 1, i == 2, i == 3);
+            glVertexAttrib4fv(1 + i, &column[0]);
+        }
+
+        glDrawArrays(stream.Mode, 0, static_cast<GLsizei>(stream.Vertices.size()));
+        RenderStats::Frame().Draw(stream.Mode, static_cast<GLsizei>(stream.Vertices.size()));
+
+        stream.Vertices.clear();
     }
 
-    void DrawPlanes() {
-        GLuint buffer = PrepareBuffer(m_PlanePrefab.VAO(), m_Planes);
-        m_PlanePrefab.DrawInstances(static_cast<GLsizei>(m_Planes.size()));
+    void SetupStream(VertexStream& stream, GLenum mode) {
+        stream.Mode = mode;
+        glGenVertexArrays(1, &stream.VAO);
+        glGenBuffers(1, &stream.Buffer);
+
+        StateCache::Instance().BindVertexArray(stream.VAO);
+        StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, stream.Buffer);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glDeleteBuffers(1, &buffer);
-        m_Planes.clear();
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
+
+        StateCache::Instance().BindVertexArray(0);
     }
 
-    void DrawCubes() {
-        GLuint buffer = PrepareBuffer(m_CubePrefab.VAO(), m_Cuboids);
-        m_CubePrefab.DrawInstances(static_cast<GLsizei>(m_Cuboids.size()));
+    static std::uint32_t PackColor(const glm::vec3& color) {
+        const auto r = static_cast<std::uint32_t>(glm::clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+        const auto g = static_cast<std::uint32_t>(glm::clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+        const auto b = static_cast<std::uint32_t>(glm::clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glDeleteBuffers(1, &buffer);
-        m_Cuboids.clear();
+        // Little endian, bytes in memory are r, g, b, a
+        return r | g << 8 | b << 16 | 0xFFu << 24;
     }
 
-    GLuint PrepareBuffer(GLuint vao, const instance_data& data) {
-        glBindVertexArray(vao);
+    // Instance attributes are pointed at the stream buffer once, buffer name never changes
+    void SetupStream(GLuint vao, InstanceStream& stream) {
+        glGenBuffers(1, &stream.Buffer);
 
-        // Prepare instance instance_buffer
-        GLuint instance_buffer;
-        glGenBuffers(1, &instance_buffer);
-        glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
-        glBufferData(GL_ARRAY_BUFFER, s_ElementSize * data.size(), &data[0], GL_STATIC_DRAW);
+        StateCache::Instance().BindVertexArray(vao);
+        StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, stream.Buffer);
 
         // Add model
         glEnableVertexAttribArray(1);
@@ -199,10 +291,7 @@ private:
         glVertexAttribDivisor(4, 1);
         glVertexAttribDivisor(5, 1);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
-        return instance_buffer;
+        StateCache::Instance().BindVertexArray(0);
     }
 };
 
@@ -5,7 +5,10 @@ layout (location = 5) in vec3 aColor;
 
 out vec3 color;
 
-uniform mat4 pv; // projection * view
+layout (std140) uniform Camera {
+    mat4 pv; // projection * view
+    vec3 viewPosition;
+};
 
 void main() {
     color = aColor;
@@ -2,189 +2,876 @@
 #include "../ICamera.h"
 #include "../IRenderListener.h"
 #include "../Texture.h"
+#include "../MeshOptimizer.h"
+#include "../MeshSimplifier.h"
+#include "../StateCache.h"
+#include "../../utilities/ThreadPool.h"
 #include "../../ZephyrEngine.h"
 
+#pragma warning(push, 0)
+#include <glm/gtc/packing.hpp>
+#pragma warning(pop)
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace {
+
+// Mirrors of the Lights uniform block in std140 layout
+struct DirectionalLightStd140 {
+    glm::vec3 Direction;
+    float Padding0;
+    glm::vec3 Ambient;
+    float Padding1;
+    glm::vec3 Diffuse;
+    float Padding2;
+    glm::vec3 Specular;
+    float Padding3;
+};
+
+struct ClustersStd140 {
+    glm::uvec4 Count;   // x, y, z, point lights count
+    glm::vec4 Depth;    // near plane, slices per logarithm of depth
+};
+
+static_assert(sizeof(DirectionalLightStd140) == 64);
+static_assert(sizeof(ClustersStd140) == 32);
+
+// Margin of projected error keeping current level of detail, prevents popping at threshold
+constexpr float LOD_HYSTERESIS = 0.25f;
+
+// Texels taken in light data buffer
+constexpr std::size_t POINTLIGHT_TEXELS = 4;
+constexpr std::size_t SPOTLIGHT_TEXELS = 5;
+
+std::size_t SelectLod(const zephyr::rendering::Phong::StaticModel::Mesh& mesh, const glm::mat4& model, std::size_t current, const glm::vec3& camera_position, float projection_scale, float threshold) {
+    const auto& lods = mesh.Lods();
+    if (lods.size() < 2) {
+        return 0;
+    }
+
+    // Distance to the closest point of world bounds, camera inside always gets full detail
+    const auto bounds = zephyr::rendering::AABB::Transform(mesh.Bounds(), model);
+    const float distance = glm::length(glm::max(glm::abs(camera_position - bounds.Center()) - bounds.Extents(), glm::vec3(0.0f)));
+    if (distance <= 0.0f) {
+        return 0;
+    }
+
+    // Error scaled to world units and projected to fraction of half of screen height
+    const float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+    auto projected_error = [&](std::size_t lod) { return lods[lod].Error * scale * projection_scale / distance; };
+
+    std::size_t desired = 0;
+    for (std::size_t lod = lods.size() - 1; lod > 0; lod--) {
+        if (projected_error(lod) < threshold) {
+            desired = lod;
+            break;
+        }
+    }
+
+    // Coarser level has to be clearly good enough, current one clearly too coarse
+    current = std::min(current, lods.size() - 1);
+    if (desired > current && projected_error(desired) >= threshold * (1.0f - LOD_HYSTERESIS)) {
+        return current;
+    }
+    if (desired < current && projected_error(current) <= threshold * (1.0f + LOD_HYSTERESIS)) {
+        return current;
+    }
+
+    return desired;
+}
+
+// Interleaved layout: position, normal, texture coordinates
+zephyr::rendering::GeometryArena::VertexFormat MeshFormat(const zephyr::rendering::Phong::StaticModel::ImportSettings& settings, std::size_t vertex_count, GLuint instance_location) {
+    const std::size_t normal_size = settings.QuantizeNormals ? sizeof(std::uint32_t) : sizeof(glm::vec3);
+    const std::size_t texture_coords_size = settings.QuantizeTexCoords ? 2 * sizeof(std::uint16_t) : sizeof(glm::vec2);
+    const std::size_t normal_offset = sizeof(glm::vec3);
+    const std::size_t texture_coords_offset = normal_offset + normal_size;
+
+    zephyr::rendering::GeometryArena::VertexFormat format;
+    format.Attributes.push_back({ 0, 3, GL_FLOAT, GL_FALSE, 0 });
+    if (settings.QuantizeNormals) {
+        format.Attributes.push_back({ 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, normal_offset });
+    } else {
+        format.Attributes.push_back({ 1, 3, GL_FLOAT, GL_FALSE, normal_offset });
+    }
+    const GLenum texture_coords_type = settings.QuantizeTexCoords ? GL_HALF_FLOAT : GL_FLOAT;
+    format.Attributes.push_back({ 2, 2, texture_coords_type, GL_FALSE, texture_coords_offset });
+    format.Stride = static_cast<GLsizei>(texture_coords_offset + texture_coords_size);
+    format.IndexType = settings.ShortIndices && vertex_count <= std::numeric_limits<GLushort>::max() ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    // Model matrix comes from instance buffer bound at draw time
+    format.FirstInstanceLocation = instance_location;
+    format.InstanceLocations = 4;
+
+    return format;
+}
+
+std::vector<unsigned char> PackVertices(const std::vector<zephyr::rendering::MeshVertex>& source_vertices, const zephyr::rendering::Phong::StaticModel::ImportSettings& settings, const zephyr::rendering::GeometryArena::VertexFormat& format) {
+    const std::size_t normal_offset = format.Attributes[1].Offset;
+    const std::size_t texture_coords_offset = format.Attributes[2].Offset;
+
+    std::vector<unsigned char> vertices(source_vertices.size() * format.Stride);
+    for (std::size_t i = 0; i < source_vertices.size(); i++) {
+        const zephyr::rendering::MeshVertex& source = source_vertices[i];
+        unsigned char* vertex = &vertices[i * format.Stride];
+
+        std::memcpy(vertex, &source.Position, sizeof(glm::vec3));
+
+        if (settings.QuantizeNormals) {
+            const std::uint32_t packed = glm::packSnorm3x10_1x2(glm::vec4(source.Normal, 0.0f));
+            std::memcpy(vertex + normal_offset, &packed, sizeof(packed));
+        } else {
+            std::memcpy(vertex + normal_offset, &source.Normal, sizeof(source.Normal));
+        }
+
+        if (settings.QuantizeTexCoords) {
+            const std::uint16_t packed[2] = { glm::packHalf1x16(source.TexCoords.x), glm::packHalf1x16(source.TexCoords.y) };
+            std::memcpy(vertex + texture_coords_offset, packed, sizeof(packed));
+        } else {
+            std::memcpy(vertex + texture_coords_offset, &source.TexCoords, sizeof(source.TexCoords));
+        }
+    }
+
+    return vertices;
+}
+
+zephyr::rendering::GeometryArena::Allocation Upload(const zephyr::rendering::GeometryArena::VertexFormat& format, const std::vector<unsigned char>& vertices, const std::vector<GLuint>& indices) {
+    const GLsizei vertex_count = static_cast<GLsizei>(vertices.size() / format.Stride);
+    const GLsizei index_count = static_cast<GLsizei>(indices.size());
+
+    if (format.IndexType == GL_UNSIGNED_SHORT) {
+        const std::vector<GLushort> short_indices(indices.begin(), indices.end());
+        return zephyr::rendering::GeometryArena::Instance().Allocate(format, vertices.data(), vertex_count, short_indices.data(), index_count);
+    }
+
+    return zephyr::rendering::GeometryArena::Instance().Allocate(format, vertices.data(), vertex_count, indices.data(), index_count);
+}
+
+// Points and lines are dropped on import, meshes made only of them have nothing to draw
+bool HasTriangles(const aiMesh& mesh) {
+    for (unsigned int i = 0; i < mesh.mNumFaces; i++) {
+        if (mesh.mFaces[i].mNumIndices == 3) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+float MaxIntensity(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular) {
+    const glm::vec3 intensity = glm::max(ambient, glm::max(diffuse, specular));
+    return std::max(intensity.x, std::max(intensity.y, intensity.z));
+}
+
+}
+
 zephyr::rendering::Phong::Phong()
     : ShaderProgram(
         "Phong",
         ReadShaderFile("../../include/Zephyr3D/rendering/shaders/PhongVert.glsl"),
         ReadShaderFile("../../include/Zephyr3D/rendering/shaders/PhongFrag.glsl"),
-        "") { }
+        "")
+    , m_LightsBuffer(EUniformBlock::Lights, sizeof(DirectionalLightStd140) + sizeof(ClustersStd140)) {
+    m_MaterialDiffuseUniform = FindUniform("material.diffuse");
+    m_MaterialSpecularUniform = FindUniform("material.specular");
+    m_MaterialShininessUniform = FindUniform("material.shininess");
+    m_LightDataUniform = FindUniform("lightData");
+    m_LightGridUniform = FindUniform("lightGrid");
+    m_LightIndicesUniform = FindUniform("lightIndices");
+
+    glGenBuffers(1, &m_InstanceBuffer);
+    glGenBuffers(1, &m_IndirectBuffer);
+    glGenBuffers(1, &m_DrawInstanceBuffer);
+}
+
+zephyr::rendering::Phong::~Phong() {
+    for (const auto& chunk : m_StaticChunks) {
+        GeometryArena::Instance().Free(chunk.Geometry);
+    }
+
+    StateCache::Instance().DeleteBuffer(m_InstanceBuffer);
+    StateCache::Instance().DeleteBuffer(m_IndirectBuffer);
+    StateCache::Instance().DeleteBuffer(m_DrawInstanceBuffer);
+}
 
 void zephyr::rendering::Phong::Draw(const ICamera* camera) {
-    glm::mat4 pv = camera->Projection() * camera->View();
-
-    Uniform("directionalLight.direction", m_DirectionalLight.Direction);
-    Uniform("directionalLight.ambient", m_DirectionalLight.Ambient);
-    Uniform("directionalLight.diffuse", m_DirectionalLight.Diffuse);
-    Uniform("directionalLight.specular", m_DirectionalLight.Specular);
-
-    for (size_t i = 0; i < m_PointLights.size(); i++) {
-        std::string index = std::to_string(i);
-        Uniform("pointLights[" + index + "].position", m_PointLights[i].second.Position);
-        Uniform("pointLights[" + index + "].constant", m_PointLights[i].second.Constant);
-        Uniform("pointLights[" + index + "].linear", m_PointLights[i].second.Linear);
-        Uniform("pointLights[" + index + "].quadratic", m_PointLights[i].second.Quadratic);
-        Uniform("pointLights[" + index + "].ambient", m_PointLights[i].second.Ambient);
-        Uniform("pointLights[" + index + "].diffuse", m_PointLights[i].second.Diffuse);
-        Uniform("pointLights[" + index + "].specular", m_PointLights[i].second.Specular);
-    }
-
-    for (size_t i = 0; i < m_SpotLights.size(); i++) {
-        std::string index = std::to_string(i);
-        Uniform("spotLights[" + index + "].position", m_SpotLights[i].second.Position);
-        Uniform("spotLights[" + index + "].direction", m_SpotLights[i].second.Direction);
-        Uniform("spotLights[" + index + "].cutOff", m_SpotLights[i].second.CutOff);
-        Uniform("spotLights[" + index + "].outerCutOff", m_SpotLights[i].second.OutterCutOff);
-        Uniform("spotLights[" + index + "].constant", m_SpotLights[i].second.Constant);
-        Uniform("spotLights[" + index + "].linear", m_SpotLights[i].second.Linear);
-        Uniform("spotLights[" + index + "].quadratic", m_SpotLights[i].second.Quadratic);
-        Uniform("spotLights[" + index + "].ambient", m_SpotLights[i].second.Ambient);
-        Uniform("spotLights[" + index + "].diffuse", m_SpotLights[i].second.Diffuse);
-        Uniform("spotLights[" + index + "].specular", m_SpotLights[i].second.Specular);
-    }
-
-    Uniform("pv", pv);
-    Uniform("viewPosition", camera->LocalPosition());
-
-    for (auto& drawable : m_Drawables) {
+    if (m_LightsDirty) {
+        UploadLights();
+        m_LightsDirty = false;
+    }
+
+    UploadClusters(camera);
+
+    // Texture units are fixed for every mesh
+    Uniform(m_MaterialDiffuseUniform, 0);
+    Uniform(m_MaterialSpecularUniform, 1);
+    Uniform(m_LightDataUniform, static_cast<int>(LIGHTS_TEXTURE_UNIT));
+    Uniform(m_LightGridUniform, static_cast<int>(LIGHTS_TEXTURE_UNIT + 1));
+    Uniform(m_LightIndicesUniform, static_cast<int>(LIGHTS_TEXTURE_UNIT + 2));
+    m_LightClusters.Bind(LIGHTS_TEXTURE_UNIT);
+}
+
+void zephyr::rendering::Phong::Submit(RenderQueue& queue, const ICamera* camera) {
+    const glm::vec3 camera_position = camera->LocalPosition();
+
+    m_Batches.clear();
+    m_BatchLookup.clear();
+    m_Buckets.clear();
+    m_BucketLookup.clear();
+    m_SubmittedInstances.clear();
+
+    m_UseMultiDraw = m_MultiDrawIndirect && GLAD_GL_ARB_draw_indirect && GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance;
+
+    // Refit moved drawables, fattened leaves absorb small movements
+    for (auto& [drawable, proxy] : m_Drawables) {
         auto user_pointer = static_cast<IRenderListener*>(drawable->UserPointer());
         user_pointer->OnDrawObject();
-        drawable->Draw(*this);
+
+        m_CullingTree.Move(proxy, drawable->Bounds());
     }
+
+    if (m_StaticDirty) {
+        BuildStaticChunks();
+        m_StaticDirty = false;
+    }
+
+    const glm::mat4 projection_view = camera->Projection() * camera->View();
+    const Frustum frustum(projection_view);
+
+    m_Visible.clear();
+    m_CullingTree.Query(frustum, [this](void* drawable) {
+        m_Visible.push_back(static_cast<StaticModel*>(drawable));
+    });
+
+    m_VisibleChunks.clear();
+    m_StaticTree.Query(frustum, [this](void* chunk) {
+        m_VisibleChunks.push_back(static_cast<const StaticChunk*>(chunk));
+    });
+
+    if (m_OcclusionCulling) {
+        CullOccluded(projection_view);
+    }
+
+    RenderStats::Frame().DrawnObjects += m_Visible.size() + m_VisibleChunks.size();
+    RenderStats::Frame().CulledObjects += m_Drawables.size() - m_Visible.size() + m_StaticChunks.size() - m_VisibleChunks.size();
+
+    const float projection_scale = camera->Projection()[1][1];
+
+    // Each visible drawable owns a contiguous range of submitted meshes, so workers write without locking
+    m_VisibleOffsets.resize(m_Visible.size() + 1);
+    m_VisibleOffsets[0] = 0;
+    for (std::size_t i = 0; i < m_Visible.size(); i++) {
+        m_VisibleOffsets[i + 1] = m_VisibleOffsets[i] + m_Visible[i]->SharedAsset().Meshes().size();
+    }
+    m_SubmittedMeshes.resize(m_VisibleOffsets.back() + m_VisibleChunks.size());
+
+    const std::size_t workers = std::clamp<std::size_t>(m_Visible.size() / MIN_DRAWABLES_PER_WORKER, 1, ThreadPool::Instance().Workers());
+    const std::size_t drawables_per_worker = (m_Visible.size() + workers - 1) / workers;
+    ThreadPool::Instance().Run(workers, [&](std::size_t worker) {
+        WalkVisible(std::min(worker * drawables_per_worker, m_Visible.size()), std::min((worker + 1) * drawables_per_worker, m_Visible.size()), camera_position, projection_scale);
+    });
+
+    // Chunks are already in world space, they only need the identity instance
+    for (std::size_t i = 0; i < m_VisibleChunks.size(); i++) {
+        const StaticChunk& chunk = *m_VisibleChunks[i];
+        const BatchKey key{ GeometryArena::Instance().VAO(chunk.Geometry.Pool), chunk.Geometry.FirstIndex, chunk.Diffuse, chunk.Specular, chunk.Shininess };
+        const float depth = glm::length(chunk.Bounds.Center() - camera_position);
+
+        m_SubmittedMeshes[m_VisibleOffsets.back() + i] = { key, chunk.Geometry.IndexCount, chunk.IndexType, chunk.Geometry.BaseVertex, depth, glm::mat4(1.0f) };
+    }
+
+    // Group visible instances by mesh, level of detail and material, then batches by geometry pool and material
+    for (const auto& submitted : m_SubmittedMeshes) {
+        auto [it, inserted] = m_BatchLookup.try_emplace(submitted.Key, m_Batches.size());
+        if (inserted) {
+            const BatchKey& key = submitted.Key;
+            auto [bucket, bucket_inserted] = m_BucketLookup.try_emplace(BucketKey{ key.VAO, key.Diffuse, key.Specular, key.Shininess }, m_Buckets.size());
+            if (bucket_inserted) {
+                m_Buckets.push_back({ key.VAO, submitted.IndexType, key.Diffuse, key.Specular, key.Shininess, 0, 0, submitted.Depth });
+            }
+
+            m_Buckets[bucket->second].CommandCount++;
+            m_Batches.push_back({ submitted.IndicesCount, key.FirstIndex, submitted.BaseVertex, 0, 0, bucket->second });
+        }
+
+        Batch& batch = m_Batches[it->second];
+        batch.InstanceCount++;
+
+        Bucket& bucket = m_Buckets[batch.Bucket];
+        bucket.Depth = std::min(bucket.Depth, submitted.Depth);
+        m_SubmittedInstances.emplace_back(it->second, submitted.Model);
+    }
+
+    // Lay out instances of each batch contiguously
+    GLuint first_instance = 0;
+    for (auto& batch : m_Batches) {
+        batch.FirstInstance = first_instance;
+        first_instance += batch.InstanceCount;
+        batch.InstanceCount = 0;
+    }
+
+    m_Instances.resize(m_SubmittedInstances.size());
+    for (const auto& [batch_index, model] : m_SubmittedInstances) {
+        Batch& batch = m_Batches[batch_index];
+        m_Instances[batch.FirstInstance + batch.InstanceCount++] = model;
+    }
+
+    // Draws of each bucket are contiguous, base instance points at their instances
+    GLuint first_command = 0;
+    for (auto& bucket : m_Buckets) {
+        bucket.FirstCommand = first_command;
+        first_command += bucket.CommandCount;
+        bucket.CommandCount = 0;
+    }
+
+    m_DrawCommands.resize(m_Batches.size());
+    for (const auto& batch : m_Batches) {
+        Bucket& bucket = m_Buckets[batch.Bucket];
+        m_DrawCommands[bucket.FirstCommand + bucket.CommandCount++] = {
+            static_cast<GLuint>(batch.IndicesCount),
+            static_cast<GLuint>(batch.InstanceCount),
+            static_cast<GLuint>(batch.FirstIndex),
+            batch.BaseVertex,
+            batch.FirstInstance
+        };
+    }
+
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_Instances.size() * sizeof(glm::mat4), m_Instances.data(), GL_STREAM_DRAW);
+    RenderStats::Frame().Upload(m_Instances.size() * sizeof(glm::mat4));
+
+    if (m_UseMultiDraw) {
+        StateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, m_DrawCommands.size() * sizeof(DrawElementsIndirectCommand), m_DrawCommands.data(), GL_STREAM_DRAW);
+        RenderStats::Frame().Upload(m_DrawCommands.size() * sizeof(DrawElementsIndirectCommand));
+
+        // Backend sees only the multi draw, primitives are counted here
+        for (const auto& command : m_DrawCommands) {
+            RenderStats::Frame().Indirect(GL_TRIANGLES, command.Count, command.InstanceCount);
+        }
+    }
+
+    for (const auto& bucket : m_Buckets) {
+        const std::uint32_t material_key = (bucket.Diffuse & 0x3FF) << 10 | (bucket.Specular & 0x3FF);
+        queue.Submit({ RenderQueue::MakeKey(ERenderPass::Opaque, ID(), material_key, bucket.VAO, bucket.Depth), this, &bucket, nullptr, glm::mat4(1.0f) });
+    }
+}
+
+void zephyr::rendering::Phong::RecordPacket(const RenderPacket& packet, const RenderPacket* previous, CommandList& commands) const {
+    const auto& bucket = *static_cast<const Bucket*>(packet.Drawable);
+    const auto previous_bucket = previous ? static_cast<const Bucket*>(previous->Drawable) : nullptr;
+
+    // Other shaders were drawing in the meantime or the list starts from scratch
+    if (!previous_bucket) {
+        m_LightClusters.Bind(commands, LIGHTS_TEXTURE_UNIT);
+    }
+
+    // Packets sharing material are adjacent, state repeated after previous packet is left out
+    if (bucket.Diffuse != 0 && (!previous_bucket || bucket.Diffuse != previous_bucket->Diffuse)) {
+        commands.BindTexture(0, GL_TEXTURE_2D, bucket.Diffuse);
+    }
+
+    if (bucket.Specular != 0 && (!previous_bucket || bucket.Specular != previous_bucket->Specular)) {
+        commands.BindTexture(1, GL_TEXTURE_2D, bucket.Specular);
+    }
+
+    if (!previous_bucket || bucket.Shininess != previous_bucket->Shininess) {
+        commands.Uniform(m_MaterialShininessUniform.Location, bucket.Shininess);
+    }
+
+    const bool vao_changed = !previous_bucket || bucket.VAO != previous_bucket->VAO;
+    if (vao_changed) {
+        commands.BindVertexArray(bucket.VAO);
+    }
+
+    if (m_UseMultiDraw) {
+        // Base instance offsets the per instance attribute, one pointer serves the whole pool
+        if (vao_changed) {
+            commands.InstanceMatrix(INSTANCE_MODEL_LOCATION, m_InstanceBuffer, 0);
+        }
+
+        commands.MultiDrawElementsIndirect(GL_TRIANGLES, bucket.IndexType, m_IndirectBuffer, bucket.FirstCommand * sizeof(DrawElementsIndirectCommand), bucket.CommandCount);
+        return;
+    }
+
+    // No base instance in GL 3.3, point model attribute at the first instance of each draw
+    const std::size_t index_size = bucket.IndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    for (GLuint i = bucket.FirstCommand; i < bucket.FirstCommand + bucket.CommandCount; i++) {
+        const auto& draw = m_DrawCommands[i];
+        commands.InstanceMatrix(INSTANCE_MODEL_LOCATION, m_InstanceBuffer, draw.BaseInstance * sizeof(glm::mat4));
+        commands.DrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(draw.Count), bucket.IndexType, draw.FirstIndex * index_size, static_cast<GLsizei>(draw.InstanceCount), draw.BaseVertex);
+    }
+}
+
+std::size_t zephyr::rendering::Phong::BucketKeyHash::operator()(const BucketKey& key) const {
+    std::size_t hash = std::hash<GLuint>()(key.VAO);
+    hash = hash * 31 + std::hash<GLuint>()(key.Diffuse);
+    hash = hash * 31 + std::hash<GLuint>()(key.Specular);
+    hash = hash * 31 + std::hash<float>()(key.Shininess);
+
+    return hash;
+}
+
+std::size_t zephyr::rendering::Phong::BatchKeyHash::operator()(const BatchKey& key) const {
+    std::size_t hash = std::hash<GLuint>()(key.VAO);
+    hash = hash * 31 + std::hash<GLsizei>()(key.FirstIndex);
+    hash = hash * 31 + std::hash<GLuint>()(key.Diffuse);
+    hash = hash * 31 + std::hash<GLuint>()(key.Specular);
+    hash = hash * 31 + std::hash<float>()(key.Shininess);
+
+    return hash;
 }
 
 zephyr::rendering::Phong::DirectionalLight* zephyr::rendering::Phong::CreateDirectionalLight() {
+    m_LightsDirty = true;
     return &m_DirectionalLight;
 }
 
 void zephyr::rendering::Phong::DestroyDirectionalLight() {
     m_DirectionalLight.Direction = m_DirectionalLight.Ambient = m_DirectionalLight.Diffuse = m_DirectionalLight.Specular = glm::vec3(0.0f);
+    m_LightsDirty = true;
 }
 
 zephyr::rendering::Phong::PointLight* zephyr::rendering::Phong::CreatePointLight() {
-    auto new_light = std::find_if(m_PointLights.begin(), m_PointLights.end(), [](const auto& pair) { return !pair.first; });
-
-    if (new_light != m_PointLights.end()) {
-        new_light->first = true;
-        return &new_light->second;
-    }
-
-    return nullptr;
+    m_LightsDirty = true;
+    return m_PointLights.emplace_back(std::make_unique<PointLight>()).get();
 }
 
 void zephyr::rendering::Phong::DestroyPointLight(const PointLight* light) {
-    auto to_remove = std::remove_if(m_PointLights.begin(), m_PointLights.end(), [=](const auto& pair) { return &pair.second == light; });
+    auto to_remove = std::find_if(m_PointLights.begin(), m_PointLights.end(), [=](const auto& point_light) { return point_light.get() == light; });
 
     if (to_remove != m_PointLights.end()) {
-        to_remove->first = false;
-        to_remove->second.Position = to_remove->second.Ambient = to_remove->second.Diffuse = to_remove->second.Specular = glm::vec3(0.0f);
-        to_remove->second.Constant = to_remove->second.Linear = to_remove->second.Quadratic = 0.0f;
+        m_PointLights.erase(to_remove);
+        m_LightsDirty = true;
     }
 }
 
 zephyr::rendering::Phong::SpotLight* zephyr::rendering::Phong::CreateSpotLight() {
-    auto new_light = std::find_if(m_SpotLights.begin(), m_SpotLights.end(), [](const auto& pair) { return !pair.first; });
-
-    if (new_light != m_SpotLights.end()) {
-        new_light->first = true;
-        return &new_light->second;
-    }
-
-    return nullptr;
+    m_LightsDirty = true;
+    return m_SpotLights.emplace_back(std::make_unique<SpotLight>()).get();
 }
 
 void zephyr::rendering::Phong::DestroySpotLight(const SpotLight* light) {
-    auto to_remove = std::remove_if(m_SpotLights.begin(), m_SpotLights.end(), [=](const auto& pair) { return &pair.second == light; });
+    auto to_remove = std::find_if(m_SpotLights.begin(), m_SpotLights.end(), [=](const auto& spot_light) { return spot_light.get() == light; });
 
     if (to_remove != m_SpotLights.end()) {
-        to_remove->first = false;
-        to_remove->second.Position = to_remove->second.Direction = to_remove->second.Ambient = to_remove->second.Diffuse = to_remove->second.Specular = glm::vec3(0.0f);
-        to_remove->second.CutOff = to_remove->second.OutterCutOff = to_remove->second.Constant = to_remove->second.Linear = to_remove->second.Quadratic = 0.0f;
+        m_SpotLights.erase(to_remove);
+        m_LightsDirty = true;
     }
 }
 
 void zephyr::rendering::Phong::Register(StaticModel* static_model) {
-    assert(std::find(m_Drawables.begin(), m_Drawables.end(), static_model) == m_Drawables.end());
-    m_Drawables.push_back(static_model);
+    assert(std::find_if(m_Drawables.begin(), m_Drawables.end(), [=](const auto& pair) { return pair.first == static_model; }) == m_Drawables.end());
+    m_Drawables.emplace_back(static_model, m_CullingTree.Insert(static_model->Bounds(), static_model));
 }
 
 void zephyr::rendering::Phong::Unregister(StaticModel* static_mocel) {
-    auto to_erase = std::find(m_Drawables.begin(), m_Drawables.end(), static_mocel);
+    auto to_erase = std::find_if(m_Drawables.begin(), m_Drawables.end(), [=](const auto& pair) { return pair.first == static_mocel; });
     if (to_erase != m_Drawables.end()) {
+        m_CullingTree.Remove(to_erase->second);
         m_Drawables.erase(to_erase);
     }
 }
 
+void zephyr::rendering::Phong::RegisterStatic(StaticModel* static_model) {
+    assert(std::find(m_StaticModels.begin(), m_StaticModels.end(), static_model) == m_StaticModels.end());
+    m_StaticModels.push_back(static_model);
+    m_StaticDirty = true;
+}
+
+void zephyr::rendering::Phong::UnregisterStatic(StaticModel* static_model) {
+    auto to_erase = std::find(m_StaticModels.begin(), m_StaticModels.end(), static_model);
+    if (to_erase != m_StaticModels.end()) {
+        m_StaticModels.erase(to_erase);
+        m_StaticDirty = !m_StaticModels.empty();
+
+        // Pass is skipped without work, chunks of the last static model are released here
+        if (m_StaticModels.empty()) {
+            for (const auto& chunk : m_StaticChunks) {
+                GeometryArena::Instance().Free(chunk.Geometry);
+            }
+            m_StaticChunks.clear();
+            m_StaticTree = AABBTree(0.0f);
+            m_VisibleChunks.clear();
+        }
+    }
+}
+
+void zephyr::rendering::Phong::WalkVisible(std::size_t begin, std::size_t end, const glm::vec3& camera_position, float projection_scale) {
+    for (std::size_t visible = begin; visible < end; visible++) {
+        StaticModel* drawable = m_Visible[visible];
+        const auto& material = drawable->MaterialOverride();
+        const auto& meshes = drawable->SharedAsset().Meshes();
+        for (std::size_t i = 0; i < meshes.size(); i++) {
+            const auto& mesh = meshes[i];
+            const glm::mat4 model = mesh.Transform() * drawable->ModelMatrix();
+            const float depth = glm::length(glm::vec3(model[3]) - camera_position);
+
+            drawable->Lod(i, SelectLod(mesh, model, drawable->Lod(i), camera_position, projection_scale, m_LodThreshold));
+            const auto& lod = mesh.Lods()[drawable->Lod(i)];
+
+            const Texture* diffuse = material.Diffuse ? material.Diffuse.get() : mesh.Diffuse();
+            const Texture* specular = material.Specular ? material.Specular.get() : mesh.Specular();
+            const BatchKey key{ mesh.VAO(), lod.FirstIndex, diffuse ? diffuse->ID() : 0, specular ? specular->ID() : 0, material.Shininess.value_or(mesh.Shininess()) };
+
+            m_SubmittedMeshes[m_VisibleOffsets[visible] + i] = { key, lod.IndicesCount, mesh.IndexType(), mesh.BaseVertex(), depth, model };
+        }
+    }
+}
+
+void zephyr::rendering::Phong::CullOccluded(const glm::mat4& projection_view) {
+    m_OcclusionCuller.Begin(projection_view);
+
+    for (auto drawable : m_Visible) {
+        if (drawable->Occluder()) {
+            for (const auto& mesh : drawable->SharedAsset().Meshes()) {
+                m_OcclusionCuller.AddOccluder(mesh.CPUPositions(), mesh.CPUIndices(), mesh.Transform() * drawable->ModelMatrix());
+            }
+        }
+    }
+
+    // Static occluders keep their own geometry, chunks have no CPU copy
+    const Frustum frustum(projection_view);
+    for (auto drawable : m_StaticModels) {
+        if (drawable->Occluder() && frustum.Visible(drawable->Bounds())) {
+            for (const auto& mesh : drawable->SharedAsset().Meshes()) {
+                m_OcclusionCuller.AddOccluder(mesh.CPUPositions(), mesh.CPUIndices(), mesh.Transform() * drawable->ModelMatrix());
+            }
+        }
+    }
+
+    if (m_OcclusionCuller.OccluderTriangles() == 0) {
+        return;
+    }
+
+    m_OcclusionCuller.Rasterize();
+
+    // Occluders never hide themselves
+    m_Visible.erase(std::remove_if(m_Visible.begin(), m_Visible.end(), [this](const StaticModel* drawable) {
+        return !drawable->Occluder() && !m_OcclusionCuller.Visible(drawable->Bounds());
+    }), m_Visible.end());
+
+    m_VisibleChunks.erase(std::remove_if(m_VisibleChunks.begin(), m_VisibleChunks.end(), [this](const StaticChunk* chunk) {
+        return !chunk->Occluder && !m_OcclusionCuller.Visible(chunk->Bounds);
+    }), m_VisibleChunks.end());
+}
+
+void zephyr::rendering::Phong::BuildStaticChunks() {
+    for (const auto& chunk : m_StaticChunks) {
+        GeometryArena::Instance().Free(chunk.Geometry);
+    }
+    m_StaticChunks.clear();
+    m_StaticTree = AABBTree(0.0f);
+
+    struct ChunkKey {
+        glm::ivec3 Cell;
+        GLuint Diffuse;
+        GLuint Specular;
+        float Shininess;
+
+        bool operator<(const ChunkKey& other) const {
+            return std::tie(Cell.x, Cell.y, Cell.z, Diffuse, Specular, Shininess) < std::tie(other.Cell.x, other.Cell.y, other.Cell.z, other.Diffuse, other.Specular, other.Shininess);
+        }
+    };
+
+    struct ChunkGeometry {
+        std::vector<MeshVertex> Vertices;
+        std::vector<GLuint> Indices;
+        AABB Bounds;
+        bool Occluder{ false };
+    };
+
+    // Meshes fall into the cell holding their center, chunks may overlap a bit
+    std::map<ChunkKey, ChunkGeometry> chunks;
+    for (auto drawable : m_StaticModels) {
+        const auto& material = drawable->MaterialOverride();
+        for (const auto& mesh : drawable->SharedAsset().Meshes()) {
+            if (mesh.CPUNormals().size() != mesh.CPUPositions().size()) {
+                WARNING_LOG(Logger::ESender::Rendering, "Static model mesh imported without ImportSettings::Static, skipped");
+                continue;
+            }
+
+            const glm::mat4 model = mesh.Transform() * drawable->ModelMatrix();
+            const glm::mat3 normal_model = glm::transpose(glm::inverse(glm::mat3(model)));
+            const AABB bounds = AABB::Transform(mesh.Bounds(), model);
+
+            const Texture* diffuse = material.Diffuse ? material.Diffuse.get() : mesh.Diffuse();
+            const Texture* specular = material.Specular ? material.Specular.get() : mesh.Specular();
+            const ChunkKey key{
+                glm::ivec3(glm::floor(bounds.Center() / STATIC_CHUNK_SIZE)),
+                diffuse ? diffuse->ID() : 0,
+                specular ? specular->ID() : 0,
+                material.Shininess.value_or(mesh.Shininess())
+            };
+
+            ChunkGeometry& chunk = chunks[key];
+            const GLuint base_vertex = static_cast<GLuint>(chunk.Vertices.size());
+            for (std::size_t i = 0; i < mesh.CPUPositions().size(); i++) {
+                const glm::vec3 position = glm::vec3(model * glm::vec4(mesh.CPUPositions()[i], 1.0f));
+                const glm::vec3 normal = normal_model * mesh.CPUNormals()[i];
+                chunk.Vertices.push_back({ position, glm::length(normal) > 0.0f ? glm::normalize(normal) : normal, mesh.CPUTexCoords()[i] });
+            }
+
+            for (const GLuint index : mesh.CPUIndices()) {
+                chunk.Indices.push_back(base_vertex + index);
+            }
+
+            chunk.Bounds.Expand(bounds);
+            chunk.Occluder = chunk.Occluder || drawable->Occluder();
+        }
+    }
+
+    // Tree keeps pointers into chunks, they are all in place before inserting
+    const StaticModel::ImportSettings settings;
+    m_StaticChunks.reserve(chunks.size());
+    for (const auto& [key, geometry] : chunks) {
+        if (geometry.Indices.empty()) {
+            continue;
+        }
+
+        const GeometryArena::VertexFormat format = MeshFormat(settings, geometry.Vertices.size(), INSTANCE_MODEL_LOCATION);
+        const GeometryArena::Allocation allocation = Upload(format, PackVertices(geometry.Vertices, settings, format), geometry.Indices);
+        m_StaticChunks.push_back({ allocation, format.IndexType, key.Diffuse, key.Specular, key.Shininess, geometry.Bounds, geometry.Occluder });
+    }
+
+    for (auto& chunk : m_StaticChunks) {
+        m_StaticTree.Insert(chunk.Bounds, &chunk);
+    }
+
+    INFO_LOG(Logger::ESender::Rendering, "Merged %zu static models into %zu chunks", m_StaticModels.size(), m_StaticChunks.size());
+}
+
+void zephyr::rendering::Phong::UploadLights() {
+    DirectionalLightStd140 directional_light{};
+    directional_light.Direction = m_DirectionalLight.Direction;
+    directional_light.Ambient = m_DirectionalLight.Ambient;
+    directional_light.Diffuse = m_DirectionalLight.Diffuse;
+    directional_light.Specular = m_DirectionalLight.Specular;
+    m_LightsBuffer.Update(&directional_light, sizeof(directional_light));
+
+    m_LightVolumes.clear();
+    m_LightTexels.clear();
+    m_LightTexels.reserve(m_PointLights.size() * POINTLIGHT_TEXELS + m_SpotLights.size() * SPOTLIGHT_TEXELS);
+
+    for (const auto& light : m_PointLights) {
+        const float intensity = MaxIntensity(light->Ambient, light->Diffuse, light->Specular);
+        m_LightVolumes.push_back({ light->Position, LightClusters::AttenuationRadius(light->Constant, light->Linear, light->Quadratic, intensity) });
+
+        m_LightTexels.emplace_back(light->Position, light->Constant);
+        m_LightTexels.emplace_back(light->Ambient, light->Linear);
+        m_LightTexels.emplace_back(light->Diffuse, light->Quadratic);
+        m_LightTexels.emplace_back(light->Specular, 0.0f);
+    }
+
+    // Cone is bounded by sphere of the attenuation radius
+    for (const auto& light : m_SpotLights) {
+        const float intensity = MaxIntensity(light->Ambient, light->Diffuse, light->Specular);
+        m_LightVolumes.push_back({ light->Position, LightClusters::AttenuationRadius(light->Constant, light->Linear, light->Quadratic, intensity) });
+
+        m_LightTexels.emplace_back(light->Position, light->CutOff);
+        m_LightTexels.emplace_back(light->Direction, light->OutterCutOff);
+        m_LightTexels.emplace_back(light->Ambient, light->Constant);
+        m_LightTexels.emplace_back(light->Diffuse, light->Linear);
+        m_LightTexels.emplace_back(light->Specular, light->Quadratic);
+    }
+
+    m_LightClusters.UploadLightData(m_LightTexels);
+}
+
+void zephyr::rendering::Phong::UploadClusters(const ICamera* camera) {
+    m_LightClusters.Assign(camera->Projection(), camera->View(), m_LightVolumes);
 
-zephyr::rendering::Phong::StaticModel::StaticModel(const aiScene& raw_model, const std::string& directory) {
-    m_StaticMeshes.reserve(raw_model.mNumMeshes);
-    LoadNode(*raw_model.mRootNode, raw_model, directory, aiMatrix4x4());
+    ClustersStd140 clusters{};
+    clusters.Count = glm::uvec4(LightClusters::CLUSTERS_X, LightClusters::CLUSTERS_Y, LightClusters::CLUSTERS_Z, static_cast<GLuint>(m_PointLights.size()));
+    clusters.Depth = glm::vec4(m_LightClusters.Near(), LightClusters::CLUSTERS_Z / std::log(m_LightClusters.Far() / m_LightClusters.Near()), 0.0f, 0.0f);
+    m_LightsBuffer.Update(&clusters, sizeof(clusters), sizeof(DirectionalLightStd140));
+}
+
+
+zephyr::rendering::Phong::StaticModel::StaticModel(std::shared_ptr<const Asset> asset)
+    : m_Asset(std::move(asset))
+    , m_Lods(m_Asset->Meshes().size(), 0) {
+    UpdateBounds();
+}
+
+zephyr::rendering::Phong::StaticModel::StaticModel(const aiScene& raw_model, const std::string& directory)
+    : StaticModel(raw_model, directory, ImportSettings()) {
+}
+
+zephyr::rendering::Phong::StaticModel::StaticModel(const aiScene& raw_model, const std::string& directory, const ImportSettings& settings)
+    : m_Asset(std::make_shared<const Asset>(raw_model, directory, settings))
+    , m_Lods(m_Asset->Meshes().size(), 0) {
+    UpdateBounds();
 }
 
 void zephyr::rendering::Phong::StaticModel::Draw(const ShaderProgram& shader) const {
-    for (auto it = m_StaticMeshes.begin(); it != m_StaticMeshes.end(); it++) {
-        it->Draw(shader, m_Model);
+    const auto& phong = static_cast<const Phong&>(shader);
+    for (const auto& mesh : m_Asset->Meshes()) {
+        mesh.Draw(phong, m_Model, m_Material);
     }
 }
 
 void zephyr::rendering::Phong::StaticModel::ModelMatrix(const glm::mat4& matrix_model) {
-    m_Model = matrix_model;
+    if (matrix_model != m_Model) {
+        m_Model = matrix_model;
+        UpdateBounds();
+    }
 }
 
 glm::mat4 zephyr::rendering::Phong::StaticModel::ModelMatrix() const {
     return m_Model;
 }
 
-void zephyr::rendering::Phong::StaticModel::LoadNode(const aiNode& node, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform) {
+void zephyr::rendering::Phong::StaticModel::MaterialOverride(const Material& material) {
+    m_Material = material;
+}
+
+const zephyr::rendering::Phong::StaticModel::Material& zephyr::rendering::Phong::StaticModel::MaterialOverride() const {
+    return m_Material;
+}
+
+void zephyr::rendering::Phong::StaticModel::UpdateBounds() {
+    m_Bounds = AABB();
+    for (const auto& mesh : m_Asset->Meshes()) {
+        m_Bounds.Expand(AABB::Transform(mesh.Bounds(), mesh.Transform() * m_Model));
+    }
+}
+
+
+zephyr::rendering::Phong::StaticModel::Asset::Asset(const aiScene& raw_model, const std::string& directory, const ImportSettings& settings) {
+    m_Meshes.reserve(raw_model.mNumMeshes);
+    LoadNode(*raw_model.mRootNode, raw_model, directory, aiMatrix4x4(), settings);
+}
+
+std::size_t zephyr::rendering::Phong::StaticModel::Asset::Size() const {
+    std::size_t size = 0;
+    for (const auto& mesh : m_Meshes) {
+        size += mesh.Size();
+    }
+
+    return size;
+}
+
+void zephyr::rendering::Phong::StaticModel::Asset::LoadNode(const aiNode& node, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform, const ImportSettings& settings) {
     aiMatrix4x4 curr = transform * node.mTransformation;
 
     for (unsigned int i = 0; i < node.mNumMeshes; i++) {
-        m_StaticMeshes.emplace_back(*scene.mMeshes[node.mMeshes[i]], scene, directory, curr);
+        const aiMesh& mesh = *scene.mMeshes[node.mMeshes[i]];
+        if (HasTriangles(mesh)) {
+            m_Meshes.emplace_back(mesh, scene, directory, curr, settings);
+        }
     }
 
     for (unsigned int i = 0; i < node.mNumChildren; i++) {
-        LoadNode(*node.mChildren[i], scene, directory, curr);
+        LoadNode(*node.mChildren[i], scene, directory, curr, settings);
     }
 }
 
 
-zephyr::rendering::Phong::StaticModel::Mesh::Mesh(const aiMesh& mesh, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform)
+zephyr::rendering::Phong::StaticModel::Mesh::Mesh(const aiMesh& mesh, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform, const ImportSettings& settings)
     : m_Shininess(1.0f)
     , m_Transform(glm::transpose(glm::make_mat4(&transform.a1))) {
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_Positions);
-    glGenBuffers(1, &m_Normals);
-    glGenBuffers(1, &m_TextureCoords);
-    glGenBuffers(1, &m_EBO);
+    // TODO multiple textures
+    std::vector<MeshVertex> source_vertices(mesh.mNumVertices);
+    for (unsigned int i = 0; i < mesh.mNumVertices; i++) {
+        source_vertices[i].Position = glm::vec3(mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z);
+        source_vertices[i].Normal = mesh.mNormals ? glm::vec3(mesh.mNormals[i].x, mesh.mNormals[i].y, mesh.mNormals[i].z) : glm::vec3(0.0f);
+        source_vertices[i].TexCoords = mesh.mTextureCoords[0] ? glm::vec2(mesh.mTextureCoords[0][i].x, mesh.mTextureCoords[0][i].y) : glm::vec2(0.0f);
+    }
+
+    std::vector<GLuint> source_indices;
+    source_indices.reserve(mesh.mNumFaces * 3);
+    for (unsigned int i = 0; i < mesh.mNumFaces; i++) {
+        // Points and lines left in scenes imported without aiProcess_SortByPType aren't drawn
+        const aiFace& face = mesh.mFaces[i];
+        if (face.mNumIndices == 3) {
+            source_indices.insert(source_indices.end(), face.mIndices, face.mIndices + 3);
+        }
+    }
 
-    glBindVertexArray(m_VAO);
+    MeshOptimizer optimizer(std::move(source_vertices), std::move(source_indices));
+    if (settings.Optimize) {
+        const float acmr = optimizer.ACMR();
+        const float overdraw = optimizer.Overdraw();
+        const std::size_t vertex_count = optimizer.Vertices().size();
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_Positions);
-    glBufferData(GL_ARRAY_BUFFER, mesh.mNumVertices * sizeof(aiVector3D), mesh.mVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_TRUE, 0, (void*)0);
-    glEnableVertexAttribArray(0);
+        optimizer.Deduplicate();
+        optimizer.OptimizeVertexCache();
+        optimizer.OptimizeOverdraw();
+        optimizer.OptimizeVertexFetch();
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_Normals);
-    glBufferData(GL_ARRAY_BUFFER, mesh.mNumVertices * sizeof(aiVector3D), mesh.mNormals, GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, 0, (void*)0);
-    glEnableVertexAttribArray(1);
+        INFO_LOG(Logger::ESender::Rendering, "Optimized mesh %s: vertices %zu -> %zu, ACMR %.3f -> %.3f, overdraw %.3f -> %.3f",
+            mesh.mName.C_Str(), vertex_count, optimizer.Vertices().size(), acmr, optimizer.ACMR(), overdraw, optimizer.Overdraw());
+    }
 
-    // TODO multiple textures
-    glBindBuffer(GL_ARRAY_BUFFER, m_TextureCoords);
-    glBufferData(GL_ARRAY_BUFFER, mesh.mNumVertices * sizeof(aiVector3D), mesh.mTextureCoords[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_TRUE, sizeof(aiVector3D), (void*)0);
-    glEnableVertexAttribArray(2);
+    const std::vector<MeshVertex> mesh_vertices = optimizer.ReleaseVertices();
+    std::vector<GLuint> indices = optimizer.ReleaseIndices();
 
-    std::vector<GLuint> indices;
-    for (unsigned int i = 0; i < mesh.mNumFaces; i++) {
-        const aiFace& face = mesh.mFaces[i];
-        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    // Meshes imported with the same settings share pool and vertex array
+    const GeometryArena::VertexFormat format = MeshFormat(settings, mesh_vertices.size(), INSTANCE_MODEL_LOCATION);
+    const std::vector<unsigned char> vertices = PackVertices(mesh_vertices, settings, format);
+
+    m_CPUPositions.reserve(mesh_vertices.size());
+    for (const auto& vertex : mesh_vertices) {
+        m_CPUPositions.push_back(vertex.Position);
+        m_Bounds.Expand(vertex.Position);
+    }
+
+    // Only meshes of static models are merged, others never read these again
+    if (settings.Static) {
+        m_CPUNormals.reserve(mesh_vertices.size());
+        m_CPUTexCoords.reserve(mesh_vertices.size());
+        for (const auto& vertex : mesh_vertices) {
+            m_CPUNormals.push_back(vertex.Normal);
+            m_CPUTexCoords.push_back(vertex.TexCoords);
+        }
+    }
+
+    m_IndicesCount = static_cast<GLsizei>(indices.size());
+
+    // Levels of detail share vertices, their index lists follow the base one in the element buffer
+    std::vector<GLuint> lod_indices(indices);
+    m_Lods.push_back({ 0, m_IndicesCount, 0.0f });
+    if (settings.LodLevels > 0 && !indices.empty()) {
+        MeshSimplifier simplifier(mesh_vertices);
+        std::size_t target = indices.size();
+
+        for (std::size_t level = 1; level <= settings.LodLevels; level++) {
+            target = static_cast<std::size_t>(target * settings.LodReduction);
+
+            float error = 0.0f;
+            auto simplified = simplifier.Simplify(indices, target, settings.LodMaxError * simplifier.Extent(), error);
+
+            // Locked seams or error limit stopped the simplification
+            if (simplified.empty() || simplified.size() > m_Lods.back().IndicesCount * 0.9f) {
+                break;
+            }
+
+            MeshOptimizer lod_optimizer(mesh_vertices, std::move(simplified));
+            lod_optimizer.OptimizeVertexCache();
+
+            m_Lods.push_back({ static_cast<GLsizei>(lod_indices.size()), static_cast<GLsizei>(lod_optimizer.Indices().size()), error });
+            lod_indices.insert(lod_indices.end(), lod_optimizer.Indices().begin(), lod_optimizer.Indices().end());
+        }
+
+        INFO_LOG(Logger::ESender::Rendering, "Generated %zu levels of detail for mesh %s, %d -> %d indices",
+            m_Lods.size() - 1, mesh.mName.C_Str(), m_Lods.front().IndicesCount, m_Lods.back().IndicesCount);
+    }
+
+    m_IndexType = format.IndexType;
+    m_Geometry = Upload(format, vertices, lod_indices);
+    m_Size = vertices.size() + lod_indices.size() * (m_IndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+
+    // Levels of detail address the pool element buffer
+    for (auto& lod : m_Lods) {
+        lod.FirstIndex += m_Geometry.FirstIndex;
     }
-    m_IndicesCount = indices.size();
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
+    m_CPUIndices = std::move(indices);
 
     if (mesh.mMaterialIndex >= 0) {
         const aiMaterial* material = scene.mMaterials[mesh.mMaterialIndex];
@@ -192,13 +879,13 @@ zephyr::rendering::Phong::StaticModel::Mesh::Mesh(const aiMesh& mesh, const aiSc
         if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
             aiString path;
             material->GetTexture(aiTextureType_DIFFUSE, 0, &path);
-            m_Diffuse = std::make_unique<Texture>(ZephyrEngine::Instance().Resources().LoadImage(directory + '/' + path.C_Str()), Texture::EType::Diffuse);
+            m_Diffuse = ZephyrEngine::Instance().Resources().LoadTexture(directory + '/' + path.C_Str(), Texture::EType::Diffuse);
         }
 
         if (material->GetTextureCount(aiTextureType_SPECULAR) > 0) {
             aiString path;
             material->GetTexture(aiTextureType_SPECULAR, 0, &path);
-            m_Specular = std::make_unique<Texture>(ZephyrEngine::Instance().Resources().LoadImage(directory + '/' + path.C_Str()), Texture::EType::Specular);
+            m_Specular = ZephyrEngine::Instance().Resources().LoadTexture(directory + '/' + path.C_Str(), Texture::EType::Specular);
         }
 
         float strength = 1.0f;
@@ -206,66 +893,74 @@ zephyr::rendering::Phong::StaticModel::Mesh::Mesh(const aiMesh& mesh, const aiSc
         material->Get(AI_MATKEY_SHININESS_STRENGTH, strength);
         m_Shininess *= strength;
     }
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 zephyr::rendering::Phong::StaticModel::Mesh::Mesh(Mesh&& other) noexcept
-    : m_VAO(std::exchange(other.m_VAO, 0))
-    , m_Positions(std::exchange(other.m_Positions, 0))
-    , m_Normals(std::exchange(other.m_Normals, 0))
-    , m_TextureCoords(std::exchange(other.m_TextureCoords, 0))
-    , m_EBO(std::exchange(other.m_EBO, 0))
+    : m_Geometry(std::exchange(other.m_Geometry, GeometryArena::Allocation()))
     , m_Diffuse(std::move(other.m_Diffuse))
-    , m_Specular(std::move(other.m_Specular)) {
+    , m_Specular(std::move(other.m_Specular))
+    , m_Lods(std::move(other.m_Lods))
+    , m_CPUPositions(std::move(other.m_CPUPositions))
+    , m_CPUIndices(std::move(other.m_CPUIndices))
+    , m_CPUNormals(std::move(other.m_CPUNormals))
+    , m_CPUTexCoords(std::move(other.m_CPUTexCoords)) {
     m_IndicesCount = other.m_IndicesCount;
+    m_IndexType = other.m_IndexType;
     m_Shininess = other.m_Shininess;
+    m_Transform = other.m_Transform;
+    m_Bounds = other.m_Bounds;
+    m_Size = other.m_Size;
 }
 
 zephyr::rendering::Phong::StaticModel::Mesh& zephyr::rendering::Phong::StaticModel::Mesh::operator=(Mesh&& other) noexcept {
-    m_VAO = std::exchange(other.m_VAO, 0);
-    m_Positions = std::exchange(other.m_Positions, 0);
-    m_Normals = std::exchange(other.m_Normals, 0);
-    m_TextureCoords = std::exchange(other.m_TextureCoords, 0);
-    m_EBO = std::exchange(other.m_EBO, 0);
+    GeometryArena::Instance().Free(m_Geometry);
+    m_Geometry = std::exchange(other.m_Geometry, GeometryArena::Allocation());
     m_Diffuse = std::move(other.m_Diffuse);
-    m_Specular = std::move(other.m_Diffuse);
+    m_Specular = std::move(other.m_Specular);
     m_IndicesCount = other.m_IndicesCount;
+    m_IndexType = other.m_IndexType;
     m_Shininess = other.m_Shininess;
+    m_Transform = other.m_Transform;
+    m_Bounds = other.m_Bounds;
+    m_Size = other.m_Size;
+    m_Lods = std::move(other.m_Lods);
+    m_CPUPositions = std::move(other.m_CPUPositions);
+    m_CPUIndices = std::move(other.m_CPUIndices);
+    m_CPUNormals = std::move(other.m_CPUNormals);
+    m_CPUTexCoords = std::move(other.m_CPUTexCoords);
 
     return *this;
 }
 
 zephyr::rendering::Phong::StaticModel::Mesh::~Mesh() {
-    glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_Positions);
-    glDeleteBuffers(1, &m_Normals);
-    glDeleteBuffers(1, &m_TextureCoords);
-    glDeleteBuffers(1, &m_EBO);
+    GeometryArena::Instance().Free(m_Geometry);
 }
 
-void zephyr::rendering::Phong::StaticModel::Mesh::Draw(const ShaderProgram& shader, const glm::mat4& model) const {
-    shader.Uniform("model", m_Transform * model);
-
-    if (m_Diffuse) {
-        glActiveTexture(GL_TEXTURE0);
-        shader.Uniform("material.diffuse", 0);
-        glBindTexture(GL_TEXTURE_2D, m_Diffuse->ID());
+void zephyr::rendering::Phong::StaticModel::Mesh::Draw(const Phong& shader, const glm::mat4& model, const Material& material) const {
+    const Texture* diffuse = material.Diffuse ? material.Diffuse.get() : m_Diffuse.get();
+    if (diffuse) {
+        StateCache::Instance().BindTexture(0, GL_TEXTURE_2D, diffuse->ID());
     }
 
-    if (m_Specular) {
-        glActiveTexture(GL_TEXTURE1);
-        shader.Uniform("material.specular", 1);
-        glBindTexture(GL_TEXTURE_2D, m_Specular->ID());
+    const Texture* specular = material.Specular ? material.Specular.get() : m_Specular.get();
+    if (specular) {
+        StateCache::Instance().BindTexture(1, GL_TEXTURE_2D, specular->ID());
     }
 
-    shader.Uniform("material.shininess", m_Shininess);
+    shader.Uniform(shader.m_MaterialShininessUniform, material.Shininess.value_or(m_Shininess));
 
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_IndicesCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    StateCache::Instance().BindVertexArray(VAO());
 
-    glActiveTexture(GL_TEXTURE0);
-}
\ No newline at end of file
+    // Single instance, pool keeps its instance attributes enabled so the matrix goes through a buffer
+    const glm::mat4 transform = m_Transform * model;
+    StateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, shader.m_DrawInstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(transform), &transform, GL_STREAM_DRAW);
+    RenderStats::Frame().Upload(sizeof(transform));
+    for (GLuint i = 0; i < 4; i++) {
+        glVertexAttribPointer(INSTANCE_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+    }
+
+    const std::size_t index_size = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    glDrawElementsBaseVertex(GL_TRIANGLES, m_IndicesCount, m_IndexType, (void*)(m_Lods.front().FirstIndex * index_size), m_Geometry.BaseVertex);
+    RenderStats::Frame().Draw(GL_TRIANGLES, m_IndicesCount);
+}
@@ -2,7 +2,12 @@
 #define Phong_h
 
 #include "../ShaderProgram.h"
+#include "../UniformBuffer.h"
+#include "../LightClusters.h"
 #include "../IDrawable.h"
+#include "../GeometryArena.h"
+#include "../culling/AABBTree.h"
+#include "../culling/OcclusionCuller.h"
 
 #pragma warning(push, 0)
 #include <glm/glm.hpp>
@@ -11,6 +16,8 @@
 #include <assimp/scene.h>
 #pragma warning(pop)
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <optional>
 
@@ -25,8 +32,17 @@ class Texture;
 class IRenderListener;
 
 class Phong : public ShaderProgram {
-    const size_t MAX_POINTLIGHTS = 4;
-    const size_t MAX_SPOTLIGHTS = 4;
+    // Light data, cluster grid and light indices use three units starting here
+    static constexpr GLuint LIGHTS_TEXTURE_UNIT = 2;
+
+    // Model matrix is passed as per instance attribute occupying four locations
+    static constexpr GLuint INSTANCE_MODEL_LOCATION = 3;
+
+    // Visible drawables walked by one worker at least, fewer are walked on the calling thread
+    static constexpr std::size_t MIN_DRAWABLES_PER_WORKER = 256;
+
+    // Edge of grid cells static geometry is merged in, in world units
+    static constexpr float STATIC_CHUNK_SIZE = 32.0f;
 
 public:
     class StaticModel;
@@ -66,9 +82,17 @@ public:
     Phong& operator=(const Phong&) = delete;
     Phong(Phong&&) = delete;
     Phong& operator=(Phong&&) = delete;
-    ~Phong() = default;
+    ~Phong();
 
+    bool HasWork() const override { return !m_Drawables.empty() || !m_StaticModels.empty(); }
     void Draw(const ICamera* camera) override;
+    void Submit(RenderQueue& queue, const ICamera* camera) override;
+    void RecordPacket(const RenderPacket& packet, const RenderPacket* previous, CommandList& commands) const override;
+
+    // Lights are uploaded only after a change is reported
+    // Call LightsChanged after modifying light returned by Create* functions
+    // Point and spot lights aren't limited, each fragment shades only lights of its cluster
+    void LightsChanged() { m_LightsDirty = true; }
 
     DirectionalLight* CreateDirectionalLight();
     void DestroyDirectionalLight();
@@ -80,20 +104,202 @@ public:
     void Register(StaticModel* static_model);
     void Unregister(StaticModel* static_mocel);
 
+    // Static models are never moved again, meshes of all of them are merged into world space chunks
+    // of one material before next frame. Chunks are culled as a whole, levels of detail aren't used.
+    // Assets of static models have to be imported with ImportSettings::Static.
+    void RegisterStatic(StaticModel* static_model);
+    void UnregisterStatic(StaticModel* static_model);
+
+    // Drawables hidden behind visible occluders are skipped
+    // Disabled by default, enable once occluders are marked as it only costs time without them
+    void OcclusionCulling(bool enabled) { m_OcclusionCulling = enabled; }
+    bool OcclusionCulling() const { return m_OcclusionCulling; }
+
+    // Largest accepted simplification error projected on screen, in fraction of half of screen height
+    void LodThreshold(float threshold) { m_LodThreshold = threshold; }
+    float LodThreshold() const { return m_LodThreshold; }
+
+    // Buckets sharing geometry pool and material go out as one indirect multi draw when
+    // ARB_multi_draw_indirect and ARB_base_instance are supported, otherwise draw by draw
+    void MultiDrawIndirect(bool enabled) { m_MultiDrawIndirect = enabled; }
+    bool MultiDrawIndirect() const { return m_MultiDrawIndirect; }
+
 private:
-    std::vector<StaticModel*> m_Drawables;
+    // Instances of one mesh level of detail with the same material, drawn with one instanced draw
+    struct Batch {
+        GLsizei IndicesCount;
+        GLsizei FirstIndex;
+        GLint BaseVertex;
+        GLuint FirstInstance;
+        GLsizei InstanceCount;
+        std::size_t Bucket;
+    };
+
+    // Batches sharing geometry pool and material, one render packet each
+    struct Bucket {
+        GLuint VAO;
+        GLenum IndexType;
+        GLuint Diffuse;
+        GLuint Specular;
+        float Shininess;
+        GLuint FirstCommand;
+        GLsizei CommandCount;
+        float Depth;
+    };
+
+    struct BucketKey {
+        GLuint VAO;
+        GLuint Diffuse;
+        GLuint Specular;
+        float Shininess;
+
+        bool operator==(const BucketKey& other) const {
+            return VAO == other.VAO && Diffuse == other.Diffuse && Specular == other.Specular && Shininess == other.Shininess;
+        }
+    };
+
+    struct BucketKeyHash {
+        std::size_t operator()(const BucketKey& key) const;
+    };
+
+    // Layout consumed by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint Count;
+        GLuint InstanceCount;
+        GLuint FirstIndex;
+        GLint BaseVertex;
+        GLuint BaseInstance;
+    };
+
+    struct BatchKey {
+        GLuint VAO;
+        GLsizei FirstIndex;
+        GLuint Diffuse;
+        GLuint Specular;
+        float Shininess;
+
+        bool operator==(const BatchKey& other) const {
+            return VAO == other.VAO && FirstIndex == other.FirstIndex && Diffuse == other.Diffuse && Specular == other.Specular && Shininess == other.Shininess;
+        }
+    };
+
+    struct BatchKeyHash {
+        std::size_t operator()(const BatchKey& key) const;
+    };
+
+    // Pre-transformed meshes of static models sharing grid cell and material
+    struct StaticChunk {
+        GeometryArena::Allocation Geometry;
+        GLenum IndexType;
+        GLuint Diffuse;
+        GLuint Specular;
+        float Shininess;
+        AABB Bounds;
+        bool Occluder;  // Contains occluder geometry, never hidden by it
+    };
+
+    // Visible mesh with level of detail chosen, written by workers walking visible drawables
+    struct SubmittedMesh {
+        BatchKey Key;
+        GLsizei IndicesCount;
+        GLenum IndexType;
+        GLint BaseVertex;
+        float Depth;
+        glm::mat4 Model;
+    };
+
+    std::vector<std::pair<StaticModel* /*drawable*/, int /*culling proxy*/>> m_Drawables;
+    AABBTree m_CullingTree;
+    std::vector<StaticModel*> m_Visible;
+    std::vector<std::size_t> m_VisibleOffsets;
+    std::vector<SubmittedMesh> m_SubmittedMeshes;
+    OcclusionCuller m_OcclusionCuller;
+
+    std::vector<StaticModel*> m_StaticModels;
+    std::vector<StaticChunk> m_StaticChunks;
+    AABBTree m_StaticTree{ 0.0f };
+    std::vector<const StaticChunk*> m_VisibleChunks;
+    bool m_StaticDirty{ false };
+    bool m_OcclusionCulling{ false };
+    float m_LodThreshold{ 0.002f };
+    bool m_MultiDrawIndirect{ true };
+    bool m_UseMultiDraw{ false };
+
+    // Per frame instancing data
+    std::vector<Batch> m_Batches;
+    std::unordered_map<BatchKey, std::size_t, BatchKeyHash> m_BatchLookup;
+    std::vector<Bucket> m_Buckets;
+    std::unordered_map<BucketKey, std::size_t, BucketKeyHash> m_BucketLookup;
+    std::vector<std::pair<std::size_t /*batch*/, glm::mat4 /*model*/>> m_SubmittedInstances;
+    std::vector<glm::mat4> m_Instances;
+    std::vector<DrawElementsIndirectCommand> m_DrawCommands;
+    GLuint m_InstanceBuffer{ 0 };
+    GLuint m_IndirectBuffer{ 0 };
+    GLuint m_DrawInstanceBuffer{ 0 };   // Model matrix of mesh drawn directly through Draw
 
     DirectionalLight m_DirectionalLight;
-    std::vector<std::pair<bool /*is used*/, PointLight /*light struct*/>> m_PointLights{ MAX_POINTLIGHTS };
-    std::vector<std::pair<bool /*is used*/, SpotLight /*light struct*/>> m_SpotLights{ MAX_POINTLIGHTS };
+    std::vector<std::unique_ptr<PointLight>> m_PointLights;
+    std::vector<std::unique_ptr<SpotLight>> m_SpotLights;
+
+    UniformBuffer m_LightsBuffer;
+    bool m_LightsDirty{ true };
+
+    // Point lights followed by spot lights
+    LightClusters m_LightClusters;
+    std::vector<LightClusters::LightVolume> m_LightVolumes;
+    std::vector<glm::vec4> m_LightTexels;
+
+    // Uniform locations resolved once
+    UniformId m_MaterialDiffuseUniform;
+    UniformId m_MaterialSpecularUniform;
+    UniformId m_MaterialShininessUniform;
+    UniformId m_LightDataUniform;
+    UniformId m_LightGridUniform;
+    UniformId m_LightIndicesUniform;
+
+    void UploadLights();
+    void UploadClusters(const ICamera* camera);
+    void BuildStaticChunks();
+    void WalkVisible(std::size_t begin, std::size_t end, const glm::vec3& camera_position, float projection_scale);
+    void CullOccluded(const glm::mat4& projection_view);
 };
 
 
 class Phong::StaticModel : public IDrawable {
 public:
+    class Mesh;
+    class Asset;
+
+    // Vertex format chosen when meshes are uploaded
+    // Positions stay full floats, quantized vertex takes 20 bytes instead of 32
+    struct ImportSettings {
+        bool QuantizeNormals{ true };       // Signed 10:10:10:2 instead of three floats
+        bool QuantizeTexCoords{ false };    // Half floats instead of floats, visibly off for UVs tiled far past 1
+        bool ShortIndices{ true };          // 16 bit indices when vertex count allows
+        bool Optimize{ true };              // Reorder for vertex cache, overdraw and fetch locality
+        std::size_t LodLevels{ 3 };         // Simplified levels generated after the base mesh
+        float LodReduction{ 0.5f };         // Triangles kept by each level relative to previous one
+        float LodMaxError{ 0.02f };         // Largest surface deviation relative to mesh extent
+        bool Static{ false };               // Keep normals and texture coordinates for merging into static chunks
+    };
+
+    // Per instance overrides of materials loaded with the asset
+    struct Material {
+        std::shared_ptr<Texture> Diffuse{ nullptr };
+        std::shared_ptr<Texture> Specular{ nullptr };
+        std::optional<float> Shininess;
+    };
+
     class Mesh {
     public:
-        Mesh(const aiMesh& mesh, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform);
+        // Range of pool element buffer used by one level of detail
+        struct Lod {
+            GLsizei FirstIndex;
+            GLsizei IndicesCount;
+            float Error;    // Simplification error in vertex space units
+        };
+
+        Mesh(const aiMesh& mesh, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform, const ImportSettings& settings);
 
         Mesh() = delete;
         Mesh(const Mesh&) = delete;
@@ -102,26 +308,76 @@ public:
         Mesh& operator=(Mesh&& other) noexcept;
         ~Mesh();
 
-        void Draw(const ShaderProgram& shader, const glm::mat4& model) const;
+        void Draw(const Phong& shader, const glm::mat4& model, const Material& material) const;
 
-    private:
-        GLuint m_VAO;
+        // Video memory taken in geometry pool in bytes
+        std::size_t Size() const { return m_Size; }
+
+        // Indices are local to the mesh, draws add base vertex of its pool range
+        GLuint VAO() const { return GeometryArena::Instance().VAO(m_Geometry.Pool); }
+        GLint BaseVertex() const { return m_Geometry.BaseVertex; }
+        GLsizei IndicesCount() const { return m_IndicesCount; }
+        GLenum IndexType() const { return m_IndexType; }
+        const std::vector<Lod>& Lods() const { return m_Lods; }
+        const Texture* Diffuse() const { return m_Diffuse.get(); }
+        const Texture* Specular() const { return m_Specular.get(); }
+        float Shininess() const { return m_Shininess; }
+        const glm::mat4& Transform() const { return m_Transform; }
+        const AABB& Bounds() const { return m_Bounds; }
 
-        // Buffer objects
-        GLuint m_Positions;
-        GLuint m_Normals;
-        GLuint m_TextureCoords;
+        // System memory copy of the geometry rasterized when model is an occluder
+        const std::vector<glm::vec3>& CPUPositions() const { return m_CPUPositions; }
+        const std::vector<GLuint>& CPUIndices() const { return m_CPUIndices; }
+
+        // Remaining attributes, empty unless imported with ImportSettings::Static
+        const std::vector<glm::vec3>& CPUNormals() const { return m_CPUNormals; }
+        const std::vector<glm::vec2>& CPUTexCoords() const { return m_CPUTexCoords; }
+
+    private:
+        // Interleaved vertices and indices suballocated from shared pool
+        GeometryArena::Allocation m_Geometry;
 
-        GLuint m_EBO;
         GLsizei m_IndicesCount;
-        std::unique_ptr<Texture> m_Diffuse{ nullptr };
-        std::unique_ptr<Texture> m_Specular{ nullptr };
+        GLenum m_IndexType;
+        std::shared_ptr<Texture> m_Diffuse{ nullptr };
+        std::shared_ptr<Texture> m_Specular{ nullptr };
         float m_Shininess;
 
         glm::mat4 m_Transform;
+        AABB m_Bounds;  // In vertex space
+        std::size_t m_Size;
+        std::vector<Lod> m_Lods;    // Base mesh first
+
+        std::vector<glm::vec3> m_CPUPositions;
+        std::vector<GLuint> m_CPUIndices;
+        std::vector<glm::vec3> m_CPUNormals;
+        std::vector<glm::vec2> m_CPUTexCoords;
     };
 
+    // Meshes uploaded once per model file and shared by every instance
+    class Asset {
+    public:
+        Asset(const aiScene& raw_model, const std::string& directory, const ImportSettings& settings);
+
+        Asset() = delete;
+        Asset(const Asset&) = delete;
+        Asset& operator=(const Asset&) = delete;
+        Asset(Asset&&) = delete;
+        Asset& operator=(Asset&&) = delete;
+        ~Asset() = default;
+
+        const std::vector<Mesh>& Meshes() const { return m_Meshes; }
+        std::size_t Size() const;
+
+    private:
+        std::vector<Mesh> m_Meshes;
+
+        void LoadNode(const aiNode& node, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform, const ImportSettings& settings);
+    };
+
+    explicit StaticModel(std::shared_ptr<const Asset> asset);
     StaticModel(const aiScene& raw_model, const std::string& directory);
+    StaticModel(const aiScene& raw_model, const std::string& directory, const ImportSettings& settings);
 
     StaticModel() = delete;
     StaticModel(const StaticModel&) = delete;
@@ -135,11 +391,32 @@ public:
     void ModelMatrix(const glm::mat4& matrix_model);
     glm::mat4 ModelMatrix() const;
 
+    // World space bounds, updated with model matrix
+    const AABB& Bounds() const { return m_Bounds; }
+
+    // Occluders are rasterized into software depth buffer to hide drawables behind them
+    // Meant for large, simple meshes like walls and terrain
+    void Occluder(bool occluder) { m_Occluder = occluder; }
+    bool Occluder() const { return m_Occluder; }
+
+    void MaterialOverride(const Material& material);
+    const Material& MaterialOverride() const;
+
+    const Asset& SharedAsset() const { return *m_Asset; }
+
+    // Level of detail selected for each mesh of the asset during last frame
+    void Lod(std::size_t mesh, std::size_t lod) { m_Lods[mesh] = static_cast<std::uint8_t>(lod); }
+    std::size_t Lod(std::size_t mesh) const { return m_Lods[mesh]; }
+
 private:
-    std::vector<StaticModel::Mesh> m_StaticMeshes;
+    std::shared_ptr<const Asset> m_Asset;
+    Material m_Material;
     glm::mat4 m_Model{0.0f};
+    AABB m_Bounds;
+    bool m_Occluder{ false };
+    std::vector<std::uint8_t> m_Lods;
 
-    void LoadNode(const aiNode& node, const aiScene& scene, const std::string& directory, const aiMatrix4x4& transform);
+    void UpdateBounds();
 };
 
 }
@@ -7,6 +7,7 @@ struct Material {
     float shininess;
 }; 
 
+// Members are ordered to pack scalars after vec3, both in std140 layout and in light data texels
 struct DirectionalLight {
     vec3 direction;
 
@@ -17,46 +18,60 @@ struct DirectionalLight {
 
 struct PointLight {
     vec3 position;
-    
     float constant;
-    float linear;
-    float quadratic;
 
     vec3 ambient;
+    float linear;
     vec3 diffuse;
+    float quadratic;
     vec3 specular;
 };
 
 struct SpotLight {
     vec3 position;
-    vec3 direction;
     float cutOff;
+    vec3 direction;
     float outerCutOff;
 
-    float constant;
-    float linear;
-    float quadratic;
-
     vec3 ambient;
+    float constant;
     vec3 diffuse;
+    float linear;
     vec3 specular;
+    float quadratic;
 };
 
 #define EPSILON 0.00001f
-#define POINTLIGHTS_COUNT 4
-#define SPOTLIGHTS_COUNT 4
+#define POINTLIGHT_TEXELS 4
+#define SPOTLIGHT_TEXELS 5
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 
-uniform vec3 viewPosition;
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLights[POINTLIGHTS_COUNT];
-uniform SpotLight spotLights[SPOTLIGHTS_COUNT];
+layout (std140) uniform Camera {
+    mat4 pv; // projection * view
+    vec3 viewPosition;
+};
+
+layout (std140) uniform Lights {
+    DirectionalLight directionalLight;
+    uvec4 clusterCount; // x, y, z, point lights count
+    vec4 clusterDepth;  // near plane, slices per logarithm of depth
+};
+
 uniform Material material;
 
+// Point lights followed by spot lights
+uniform samplerBuffer lightData;
+// Offset and count of light indices in each cluster
+uniform usamplerBuffer lightGrid;
+uniform usamplerBuffer lightIndices;
+
 bool NearZero(float value);
+uvec2 FetchCluster();
+PointLight FetchPointLight(int index);
+SpotLight FetchSpotLight(int index);
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
@@ -77,12 +92,16 @@ void main() {
 
     vec3 result = CalcDirectionalLight(directionalLight, norm, viewDir);
 
-    for (int i = 0; i < POINTLIGHTS_COUNT; i++) {
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-    }
+    // Only lights reaching cluster of the fragment
+    uvec2 cluster = FetchCluster();
+    for (uint i = 0u; i < cluster.y; i++) {
+        int light = int(texelFetch(lightIndices, int(cluster.x + i)).r);
 
-    for (int i = 0; i < SPOTLIGHTS_COUNT; i++) {
-        result += CalcSpotLight(spotLights[i], norm, FragPos, viewDir);
+        if (light < int(clusterCount.w)) {
+            result += CalcPointLight(FetchPointLight(light), norm, FragPos, viewDir);
+        } else {
+            result += CalcSpotLight(FetchSpotLight(light - int(clusterCount.w)), norm, FragPos, viewDir);
+        }
     }
 
     FragColor = vec4(result, 1.0f);
@@ -92,6 +111,37 @@ bool NearZero(float value) {
     return abs(value) < EPSILON;
 }
 
+// Slices are distributed exponentially with view depth
+uvec2 FetchCluster() {
+    vec4 clip = pv * vec4(FragPos, 1.0f);
+    vec2 tile = (clip.xy / clip.w * 0.5f + 0.5f) * vec2(clusterCount.xy);
+    float slice = log(max(clip.w, clusterDepth.x) / clusterDepth.x) * clusterDepth.y;
+
+    uvec3 cluster = uvec3(clamp(vec3(tile, slice), vec3(0.0f), vec3(clusterCount.xyz) - 1.0f));
+    return texelFetch(lightGrid, int((cluster.z * clusterCount.y + cluster.y) * clusterCount.x + cluster.x)).rg;
+}
+
+PointLight FetchPointLight(int index) {
+    int base = index * POINTLIGHT_TEXELS;
+    vec4 texel0 = texelFetch(lightData, base);
+    vec4 texel1 = texelFetch(lightData, base + 1);
+    vec4 texel2 = texelFetch(lightData, base + 2);
+    vec4 texel3 = texelFetch(lightData, base + 3);
+
+    return PointLight(texel0.xyz, texel0.w, texel1.xyz, texel1.w, texel2.xyz, texel2.w, texel3.xyz);
+}
+
+SpotLight FetchSpotLight(int index) {
+    int base = int(clusterCount.w) * POINTLIGHT_TEXELS + index * SPOTLIGHT_TEXELS;
+    vec4 texel0 = texelFetch(lightData, base);
+    vec4 texel1 = texelFetch(lightData, base + 1);
+    vec4 texel2 = texelFetch(lightData, base + 2);
+    vec4 texel3 = texelFetch(lightData, base + 3);
+    vec4 texel4 = texelFetch(lightData, base + 4);
+
+    return SpotLight(texel0.xyz, texel0.w, texel1.xyz, texel1.w, texel2.xyz, texel2.w, texel3.xyz, texel3.w, texel4.xyz, texel4.w);
+}
+
 // calculates the color when using a directional light.
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
     if (NearZero(light.direction.x) && NearZero(light.direction.y) && NearZero(light.direction.z))
@@ -2,17 +2,20 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in mat4 aModel; // per instance
 
-uniform mat4 model;
-uniform mat4 pv; // projection * view
+layout (std140) uniform Camera {
+    mat4 pv; // projection * view
+    vec3 viewPosition;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0f));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(aModel * vec4(aPos, 1.0f));
+    Normal = mat3(transpose(inverse(aModel))) * aNormal;
     TexCoords = aTexCoords;
     
     gl_Position = pv * vec4(FragPos, 1.0f);
@@ -21,6 +21,7 @@ public:
     ~PureColor() = default;
 
     void Draw(const ICamera* camera) override { }
+    bool HasWork() const override { return false; }
 };
 
 }
@@ -21,6 +21,7 @@ public:
     ~PureTexture() = default;
 
     void Draw(const ICamera* camera) override { }
+    bool HasWork() const override { return false; }
 };
 
 }
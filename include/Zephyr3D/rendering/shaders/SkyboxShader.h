@@ -4,6 +4,7 @@
 #include "../ShaderProgram.h"
 #include "../ICamera.h"
 #include "../Cubemap.h"
+#include "../StateCache.h"
 
 namespace zephyr::rendering {
 
@@ -14,7 +15,12 @@ public:
             "Skybox",
             ReadShaderFile("../../include/Zephyr3D/rendering/shaders/SkyboxVert.glsl"),
             ReadShaderFile("../../include/Zephyr3D/rendering/shaders/SkyboxFrag.glsl"),
-            "") { }
+            "")
+        , m_PVUniform(FindUniform("pv")) {
+        // Cubemap is always bound to the first unit, sampler is set once after linking
+        Use();
+        Uniform(FindUniform("skybox"), 0);
+    }
 
     SkyboxShader(const SkyboxShader&) = delete;
     SkyboxShader& operator=(const SkyboxShader&) = delete;
@@ -26,22 +32,25 @@ public:
         m_Cubemap = std::make_unique<Cubemap>(right, left, top, bottom, back, front);
     }
 
+    bool HasWork() const override { return m_Cubemap != nullptr; }
+
     void Draw(const ICamera* camera) override {
         if (m_Cubemap == nullptr) {
             return;
         }
 
-        glDepthFunc(GL_LEQUAL);
+        StateCache::Instance().DepthFunc(GL_LEQUAL);
 
         glm::mat4 pv = camera->Projection() * glm::mat4(glm::mat3(camera->View()));
-        Uniform("pv", pv);
+        Uniform(m_PVUniform, pv);
         m_Cubemap->Draw(*this);
 
-        glDepthFunc(GL_LESS);
+        StateCache::Instance().DepthFunc(GL_LESS);
     }
 
 private:
     std::unique_ptr<Cubemap> m_Cubemap{ nullptr };
+    UniformId m_PVUniform;
 };
 
 }
@@ -0,0 +1,92 @@
+#ifndef DDS_h
+#define DDS_h
+
+#include <cstdint>
+
+namespace zephyr::resources::dds {
+
+// Subset of the DirectDraw Surface container needed for block compressed textures
+// https://docs.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
+
+constexpr std::uint32_t MAGIC = 0x20534444; // "DDS "
+
+constexpr std::uint32_t FourCC(char a, char b, char c, char d) {
+    return static_cast<std::uint32_t>(a)
+        | (static_cast<std::uint32_t>(b) << 8)
+        | (static_cast<std::uint32_t>(c) << 16)
+        | (static_cast<std::uint32_t>(d) << 24);
+}
+
+constexpr std::uint32_t FOURCC_DXT1 = FourCC('D', 'X', 'T', '1');
+constexpr std::uint32_t FOURCC_DXT3 = FourCC('D', 'X', 'T', '3');
+constexpr std::uint32_t FOURCC_DXT5 = FourCC('D', 'X', 'T', '5');
+constexpr std::uint32_t FOURCC_ATI1 = FourCC('A', 'T', 'I', '1');
+constexpr std::uint32_t FOURCC_ATI2 = FourCC('A', 'T', 'I', '2');
+constexpr std::uint32_t FOURCC_DX10 = FourCC('D', 'X', '1', '0');
+
+constexpr std::uint32_t DDSD_CAPS = 0x1;
+constexpr std::uint32_t DDSD_HEIGHT = 0x2;
+constexpr std::uint32_t DDSD_WIDTH = 0x4;
+constexpr std::uint32_t DDSD_PIXELFORMAT = 0x1000;
+constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+constexpr std::uint32_t DDSD_LINEARSIZE = 0x80000;
+
+constexpr std::uint32_t DDPF_FOURCC = 0x4;
+
+constexpr std::uint32_t DDSCAPS_COMPLEX = 0x8;
+constexpr std::uint32_t DDSCAPS_TEXTURE = 0x1000;
+constexpr std::uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+// DXGI_FORMAT values used by DX10 extended header
+constexpr std::uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+constexpr std::uint32_t DXGI_FORMAT_BC2_UNORM = 74;
+constexpr std::uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+constexpr std::uint32_t DXGI_FORMAT_BC4_UNORM = 80;
+constexpr std::uint32_t DXGI_FORMAT_BC5_UNORM = 83;
+constexpr std::uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+
+#pragma pack(push, 1)
+struct PixelFormat {
+    std::uint32_t Size;
+    std::uint32_t Flags;
+    std::uint32_t FourCC;
+    std::uint32_t RGBBitCount;
+    std::uint32_t RBitMask;
+    std::uint32_t GBitMask;
+    std::uint32_t BBitMask;
+    std::uint32_t ABitMask;
+};
+
+struct Header {
+    std::uint32_t Size;
+    std::uint32_t Flags;
+    std::uint32_t Height;
+    std::uint32_t Width;
+    std::uint32_t PitchOrLinearSize;
+    std::uint32_t Depth;
+    std::uint32_t MipMapCount;
+    std::uint32_t Reserved1[11];
+    PixelFormat Format;
+    std::uint32_t Caps;
+    std::uint32_t Caps2;
+    std::uint32_t Caps3;
+    std::uint32_t Caps4;
+    std::uint32_t Reserved2;
+};
+
+struct HeaderDX10 {
+    std::uint32_t DXGIFormat;
+    std::uint32_t ResourceDimension;
+    std::uint32_t MiscFlag;
+    std::uint32_t ArraySize;
+    std::uint32_t MiscFlags2;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PixelFormat) == 32);
+static_assert(sizeof(Header) == 124);
+static_assert(sizeof(HeaderDX10) == 20);
+
+}
+
+#endif
@@ -1,8 +1,17 @@
 #include "Image.h"
 #include "ResourcesManager.h"
+#include "DDS.h"
+
+#include <fstream>
+#include <algorithm>
 
 zephyr::resources::Image::Image(const std::string& path)
     : m_Path(ASSETS_PATH_PREFIX + path) {
+    // Prefer texture cooked offline by TextureCooker
+    if (m_LoadCooked(CookedImagePath(m_Path))) {
+        return;
+    }
+
     m_Data = stbi_load(m_Path.c_str(), &m_Width, &m_Height, &m_Components, 0);
     if (!m_Data) {
         Logger::Instance().ErrorLog(Logger::ESender::Resources, __FILE__, __LINE__, "Failed to load image %s", path.c_str());
@@ -16,3 +25,119 @@ zephyr::resources::Image::Image(const std::string& path)
 zephyr::resources::Image::~Image() {
     stbi_image_free(m_Data);
 }
+
+std::size_t zephyr::resources::Image::Size() const {
+    if (m_Compression != ECompression::None) {
+        return m_Blocks.size();
+    }
+
+    return m_Data ? static_cast<std::size_t>(m_Width) * m_Height * m_Components : 0;
+}
+
+bool zephyr::resources::Image::m_LoadCooked(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::uint32_t magic = 0;
+    dds::Header header{};
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || magic != dds::MAGIC || header.Size != sizeof(dds::Header) || !(header.Format.Flags & dds::DDPF_FOURCC)) {
+        WARNING_LOG(Logger::ESender::Resources, "Invalid cooked image %s", path.c_str());
+        return false;
+    }
+
+    std::uint32_t format = header.Format.FourCC;
+    if (format == dds::FOURCC_DX10) {
+        dds::HeaderDX10 header_dx10{};
+        file.read(reinterpret_cast<char*>(&header_dx10), sizeof(header_dx10));
+        format = header_dx10.DXGIFormat;
+    }
+
+    switch (format) {
+    case dds::FOURCC_DXT1:
+    case dds::DXGI_FORMAT_BC1_UNORM:
+        m_Compression = ECompression::BC1;
+        m_Components = 3;
+        break;
+
+    case dds::FOURCC_DXT3:
+    case dds::DXGI_FORMAT_BC2_UNORM:
+        m_Compression = ECompression::BC2;
+        m_Components = 4;
+        break;
+
+    case dds::FOURCC_DXT5:
+    case dds::DXGI_FORMAT_BC3_UNORM:
+        m_Compression = ECompression::BC3;
+        m_Components = 4;
+        break;
+
+    case dds::FOURCC_ATI1:
+    case dds::DXGI_FORMAT_BC4_UNORM:
+        m_Compression = ECompression::BC4;
+        m_Components = 1;
+        break;
+
+    case dds::FOURCC_ATI2:
+    case dds::DXGI_FORMAT_BC5_UNORM:
+        m_Compression = ECompression::BC5;
+        m_Components = 2;
+        break;
+
+    case dds::DXGI_FORMAT_BC7_UNORM:
+        m_Compression = ECompression::BC7;
+        m_Components = 4;
+        break;
+
+    default:
+        WARNING_LOG(Logger::ESender::Resources, "Unsupported cooked image format %u in %s", format, path.c_str());
+        return false;
+    }
+
+    // BC1 and BC4 take 8 bytes per 4x4 block, other formats 16
+    const std::size_t block_size = (m_Compression == ECompression::BC1 || m_Compression == ECompression::BC4) ? 8 : 16;
+    const std::uint32_t level_count = (header.Flags & dds::DDSD_MIPMAPCOUNT) ? std::max(header.MipMapCount, 1u) : 1u;
+
+    std::size_t offset = 0;
+    int width = static_cast<int>(header.Width);
+    int height = static_cast<int>(header.Height);
+    m_Levels.reserve(level_count);
+    for (std::uint32_t i = 0; i < level_count; i++) {
+        const std::size_t size = ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+        m_Levels.push_back({ width, height, offset, size });
+
+        offset += size;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    m_Blocks.resize(offset);
+    file.read(reinterpret_cast<char*>(m_Blocks.data()), offset);
+    if (!file) {
+        WARNING_LOG(Logger::ESender::Resources, "Truncated cooked image %s", path.c_str());
+
+        m_Compression = ECompression::None;
+        m_Components = 0;
+        m_Blocks.clear();
+        m_Levels.clear();
+        return false;
+    }
+
+    m_Width = static_cast<int>(header.Width);
+    m_Height = static_cast<int>(header.Height);
+    return true;
+}
+
+std::string zephyr::resources::CookedImagePath(const std::string& path) {
+    const auto dot = path.find_last_of('.');
+    const auto slash = path.find_last_of("/\\");
+
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + ".dds";
+    }
+
+    return path.substr(0, dot) + ".dds";
+}
@@ -8,12 +8,30 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #pragma warning(pop)
 
 namespace zephyr::resources {
 
 class Image {
 public:
+    enum class ECompression {
+        None,
+        BC1,
+        BC2,
+        BC3,
+        BC4,
+        BC5,
+        BC7
+    };
+
+    struct Level {
+        int Width;
+        int Height;
+        std::size_t Offset;
+        std::size_t Size;
+    };
+
     explicit Image(const std::string& path);
 
     Image() = delete;
@@ -23,19 +41,34 @@ public:
     Image& operator=(Image&&) = delete;
     ~Image();
 
-    unsigned char* Data() const { return m_Data; }
+    unsigned char* Data() const { return m_Compression == ECompression::None ? m_Data : const_cast<unsigned char*>(m_Blocks.data()); }
     int Width() const { return m_Width; }
     int Height() const { return m_Height; }
     int Components() const { return m_Components; }
 
+    // Memory taken by pixel data in bytes
+    std::size_t Size() const;
+
+    // Pre-cooked images keep whole mip chain in block compressed format
+    ECompression Compression() const { return m_Compression; }
+    const std::vector<Level>& Levels() const { return m_Levels; }
+
 private:
-    unsigned char* m_Data;
-    int m_Width;
-    int m_Height;
-    int m_Components;
+    unsigned char* m_Data{ nullptr };
+    int m_Width{ 0 };
+    int m_Height{ 0 };
+    int m_Components{ 0 };
     std::string m_Path;
+
+    ECompression m_Compression{ ECompression::None };
+    std::vector<unsigned char> m_Blocks;
+    std::vector<Level> m_Levels;
+
+    bool m_LoadCooked(const std::string& path);
 };
 
+std::string CookedImagePath(const std::string& path);
+
 }
 
 #endif
@@ -0,0 +1,121 @@
+#ifndef ResourceCache_h
+#define ResourceCache_h
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace zephyr::resources {
+
+// Path keyed cache of reference counted resources
+// Entries not referenced outside of the cache are evicted in least recently used
+// order whenever resident size exceeds the budget. Budget equal to 0 disables eviction.
+template <class T>
+class ResourceCache {
+public:
+    using Handle = std::shared_ptr<T>;
+
+    explicit ResourceCache(std::size_t budget = 0)
+        : m_Budget(budget) {
+    }
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+    ResourceCache(ResourceCache&&) = delete;
+    ResourceCache& operator=(ResourceCache&&) = delete;
+    ~ResourceCache() = default;
+
+    Handle Find(const std::string& key) {
+        auto entry = m_Entries.find(key);
+        if (entry == m_Entries.end()) {
+            return nullptr;
+        }
+
+        // Mark as most recently used
+        m_LRU.splice(m_LRU.begin(), m_LRU, entry->second.LRU);
+        return entry->second.Resource;
+    }
+
+    Handle Insert(const std::string& key, Handle resource, std::size_t size) {
+        Erase(key);
+
+        m_LRU.push_front(key);
+        m_Entries.try_emplace(key, Entry{ resource, size, m_LRU.begin() });
+        m_Size += size;
+
+        Trim();
+        return resource;
+    }
+
+    void Erase(const std::string& key) {
+        auto entry = m_Entries.find(key);
+        if (entry == m_Entries.end()) {
+            return;
+        }
+
+        m_Size -= entry->second.Size;
+        m_LRU.erase(entry->second.LRU);
+        m_Entries.erase(entry);
+    }
+
+    // Evict unreferenced entries until resident size fits into the budget
+    void Trim() {
+        if (m_Budget != 0) {
+            Trim(m_Budget);
+        }
+    }
+
+    void Trim(std::size_t budget) {
+        auto it = m_LRU.end();
+        while (m_Size > budget && it != m_LRU.begin()) {
+            --it;
+
+            auto entry = m_Entries.find(*it);
+            if (entry->second.Resource.use_count() > 1) {
+                continue;
+            }
+
+            m_Size -= entry->second.Size;
+            m_Entries.erase(entry);
+            it = m_LRU.erase(it);
+        }
+    }
+
+    // Evict every unreferenced entry regardless of the budget
+    void Purge() {
+        for (auto it = m_LRU.begin(); it != m_LRU.end();) {
+            auto entry = m_Entries.find(*it);
+            if (entry->second.Resource.use_count() > 1) {
+                ++it;
+                continue;
+            }
+
+            m_Size -= entry->second.Size;
+            m_Entries.erase(entry);
+            it = m_LRU.erase(it);
+        }
+    }
+
+    void Budget(std::size_t budget) { m_Budget = budget; Trim(); }
+    std::size_t Budget() const { return m_Budget; }
+    std::size_t Size() const { return m_Size; }
+    std::size_t Count() const { return m_Entries.size(); }
+
+private:
+    struct Entry {
+        Handle Resource;
+        std::size_t Size;
+        typename std::list<std::string>::iterator LRU;
+    };
+
+    std::unordered_map<std::string, Entry> m_Entries;
+    std::list<std::string> m_LRU;   // Most recently used at the front
+    std::size_t m_Budget;
+    std::size_t m_Size{ 0 };
+};
+
+}
+
+#endif
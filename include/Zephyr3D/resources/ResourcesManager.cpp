@@ -1,27 +1,244 @@
 #include "ResourcesManager.h"
+#include "../utilities/ThreadPool.h"
 
+#include <assimp/config.h>
 #include <assimp/postprocess.h>
 
-zephyr::resources::Image& zephyr::resources::ResourcesManager::LoadImage(std::string path) {
-    if (m_Textures.find(path) == m_Textures.end()) {
-        m_Textures.try_emplace(path, path);
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// Rough estimate of memory held by the importer
+std::size_t ModelSize(const aiScene& scene) {
+    std::size_t size = 0;
+    for (unsigned int i = 0; i < scene.mNumMeshes; i++) {
+        const aiMesh& mesh = *scene.mMeshes[i];
+
+        std::size_t vertex_size = sizeof(aiVector3D);
+        vertex_size += mesh.HasNormals() ? sizeof(aiVector3D) : 0;
+        vertex_size += mesh.HasTangentsAndBitangents() ? 2 * sizeof(aiVector3D) : 0;
+        vertex_size += mesh.GetNumUVChannels() * sizeof(aiVector3D);
+        vertex_size += mesh.GetNumColorChannels() * sizeof(aiColor4D);
+
+        size += mesh.mNumVertices * vertex_size;
+        size += mesh.mNumFaces * (sizeof(aiFace) + 3 * sizeof(unsigned int));
+    }
+
+    return size;
+}
+
+// Same model imported with different vertex format is a separate asset
+std::string SettingsKey(const zephyr::rendering::Phong::StaticModel::ImportSettings& settings) {
+    std::string key;
+    key.append(1, '#').append(1, '0' + settings.QuantizeNormals).append(1, '0' + settings.QuantizeTexCoords).append(1, '0' + settings.ShortIndices).append(1, '0' + settings.Optimize).append(1, '0' + settings.Static)
+        .append(1, '#').append(std::to_string(settings.LodLevels)).append(1, '_').append(std::to_string(settings.LodReduction)).append(1, '_').append(std::to_string(settings.LodMaxError));
+
+    return key;
+}
+
+}
+
+zephyr::resources::ResourcesManager::ImageHandle zephyr::resources::ResourcesManager::LoadImage(const std::string& path) {
+    if (auto image = m_Images.Find(path)) {
+        return image;
     }
 
-    return m_Textures.at(path);
+    auto image = std::make_shared<Image>(path);
+    const std::size_t size = image->Size();
+    m_Images.Insert(path, image, size);
+    TrimCPU();
+
+    return image;
 }
 
-const aiScene& zephyr::resources::ResourcesManager::LoadModel(const std::string& path) {
+std::vector<zephyr::resources::ResourcesManager::ImageHandle> zephyr::resources::ResourcesManager::LoadImages(const std::vector<std::string>& paths) {
+    std::vector<ImageHandle> images(paths.size());
+    std::vector<std::size_t> missing;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        images[i] = m_Images.Find(paths[i]);
+        if (!images[i]) {
+            missing.push_back(i);
+        }
+    }
+
+    ThreadPool::Instance().Run(missing.size(), [&](std::size_t i) {
+        images[missing[i]] = std::make_shared<Image>(paths[missing[i]]);
+    });
+
+    // Cache is touched only from calling thread
+    for (const std::size_t i : missing) {
+        if (auto cached = m_Images.Find(paths[i])) {
+            // Same path requested more than once
+            images[i] = cached;
+            continue;
+        }
+
+        m_Images.Insert(paths[i], images[i], images[i]->Size());
+    }
+    TrimCPU();
+
+    return images;
+}
+
+zephyr::resources::ResourcesManager::ModelHandle zephyr::resources::ResourcesManager::LoadModel(const std::string& path) {
+    if (auto model = m_Models.Find(path)) {
+        return model;
+    }
+
     const std::string full_path = ASSETS_PATH_PREFIX + path;
 
-    if (m_Models2.find(full_path) == m_Models2.end()) {
-        auto& importer = m_Models2[full_path];
-        const aiScene* scene = importer.ReadFile(full_path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    const unsigned int flags = aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_JoinIdenticalVertices | aiProcess_FlipUVs;
+
+    // Meshes of points and lines are dropped, only triangles are rendered
+    auto importer = std::make_shared<Assimp::Importer>();
+    importer->SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    const aiScene* scene = importer->ReadFile(full_path, flags);
+
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        ERROR_LOG(Logger::ESender::Resources, "Failed to load model %s:\n%s", full_path.c_str(), importer->GetErrorString());
 
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            ERROR_LOG(Logger::ESender::Rendering, "Failed to load model %s:\n%s", full_path.c_str(), importer.GetErrorString());
+        // Error model is cached under requested path, so missing asset doesn't hit the disk again
+        if (path != ERROR_MODEL3D_PATH) {
+            scene = importer->ReadFile(std::string(ASSETS_PATH_PREFIX) + ERROR_MODEL3D_PATH, flags);
         }
     }
 
-    return *m_Models2[full_path].GetScene();
+    // Handle shares ownership of the importer which owns the scene
+    ModelHandle model(importer, scene);
+    m_Models.Insert(path, model, scene ? ModelSize(*scene) : 0);
+    TrimCPU();
+
+    return model;
+}
+
+zephyr::resources::ResourcesManager::TextureHandle zephyr::resources::ResourcesManager::LoadTexture(const std::string& path, rendering::Texture::EType type) {
+    // Same file loaded as different texture type is a separate texture
+    std::string key = path;
+    key.append(1, '#').append(std::to_string(static_cast<int>(type)));
+
+    if (auto texture = m_Textures.Find(key)) {
+        return texture;
+    }
+
+    auto image = LoadImage(path);
+    auto texture = std::make_shared<rendering::Texture>(*image, type);
+    m_Textures.Insert(key, texture, texture->Size());
+    TrimGPU();
+
+    // Nobody else needs the pixels, GPU copy is the only one left
+    if (m_ReleaseUploadedData && image.use_count() == 2) {
+        m_Images.Erase(path);
+    }
+
+    return texture;
+}
+
+zephyr::resources::ResourcesManager::StaticModelHandle zephyr::resources::ResourcesManager::LoadStaticModel(const std::string& path, const rendering::Phong::StaticModel::ImportSettings& settings) {
+    const std::string key = path + SettingsKey(settings);
+
+    if (auto static_model = m_StaticModels.Find(key)) {
+        return static_model;
+    }
+
+    // Textures are looked up relative to the model file
+    const auto slash = path.find_last_of("/\\");
+    const std::string directory = slash != std::string::npos ? path.substr(0, slash) : "";
+
+    auto model = LoadModel(path);
+    auto static_model = std::make_shared<const rendering::Phong::StaticModel::Asset>(*model, directory, settings);
+    m_StaticModels.Insert(key, static_model, static_model->Size());
+    TrimGPU();
+
+    if (m_ReleaseUploadedData && model.use_count() == 2) {
+        m_Models.Erase(path);
+    }
+
+    return static_model;
+}
+
+zephyr::resources::ResourcesManager::StaticModelHandle zephyr::resources::ResourcesManager::LoadStaticModel(const aiScene& raw_model, const std::string& directory, const rendering::Phong::StaticModel::ImportSettings& settings) {
+    // Expired entries are dropped first, scene freed by the caller may reuse the address of an old one
+    for (auto it = m_SceneStaticModels.begin(); it != m_SceneStaticModels.end();) {
+        it = it->second.expired() ? m_SceneStaticModels.erase(it) : std::next(it);
+    }
+
+    const std::string key = std::to_string(reinterpret_cast<std::uintptr_t>(&raw_model)) + '#' + directory + SettingsKey(settings);
+    if (auto static_model = m_SceneStaticModels[key].lock()) {
+        return static_model;
+    }
+
+    auto static_model = std::make_shared<const rendering::Phong::StaticModel::Asset>(raw_model, directory, settings);
+    m_SceneStaticModels[key] = static_model;
+
+    return static_model;
+}
+
+void zephyr::resources::ResourcesManager::CPUBudget(std::size_t budget) {
+    m_Images.Budget(budget);
+    m_Models.Budget(budget);
+    TrimCPU();
+}
+
+std::size_t zephyr::resources::ResourcesManager::CPUBudget() const {
+    return m_Images.Budget();
+}
+
+void zephyr::resources::ResourcesManager::GPUBudget(std::size_t budget) {
+    m_StaticModels.Budget(budget);
+    m_Textures.Budget(budget);
+    TrimGPU();
 }
 
+std::size_t zephyr::resources::ResourcesManager::GPUBudget() const {
+    return m_Textures.Budget();
+}
+
+std::size_t zephyr::resources::ResourcesManager::CPUUsage() const {
+    return m_Images.Size() + m_Models.Size();
+}
+
+std::size_t zephyr::resources::ResourcesManager::GPUUsage() const {
+    return m_Textures.Size() + rendering::GeometryArena::Instance().Size();
+}
+
+void zephyr::resources::ResourcesManager::Trim() {
+    TrimGPU();
+    TrimCPU();
+}
+
+void zephyr::resources::ResourcesManager::Purge() {
+    // Static models hold references to their textures
+    m_StaticModels.Purge();
+    m_Textures.Purge();
+    m_Images.Purge();
+    m_Models.Purge();
+}
+
+void zephyr::resources::ResourcesManager::TrimCPU() {
+    const std::size_t budget = m_Images.Budget();
+    if (budget == 0 || CPUUsage() <= budget) {
+        return;
+    }
+
+    // Images and models draw from the same budget, evict images first as they are cheaper to reload
+    m_Images.Trim(budget - std::min(m_Models.Size(), budget));
+    m_Models.Trim(budget - std::min(m_Images.Size(), budget));
+}
+
+void zephyr::resources::ResourcesManager::TrimGPU() {
+    const std::size_t budget = m_Textures.Budget();
+    if (budget == 0 || GPUUsage() <= budget) {
+        return;
+    }
+
+    // Evicting static model releases its textures, so models go first
+    // Geometry pools are deleted only once empty, usage may stay above budget after eviction
+    const std::size_t excess = GPUUsage() - budget;
+    m_StaticModels.Trim(m_StaticModels.Size() - std::min(excess, m_StaticModels.Size()));
+
+    if (GPUUsage() > budget) {
+        const std::size_t remaining = GPUUsage() - budget;
+        m_Textures.Trim(m_Textures.Size() - std::min(remaining, m_Textures.Size()));
+    }
+}
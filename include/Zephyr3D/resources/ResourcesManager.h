@@ -2,13 +2,19 @@
 #define ResourcesManager_h
 
 #include "Image.h"
+#include "ResourceCache.h"
+#include "../rendering/Texture.h"
+#include "../rendering/GeometryArena.h"
+#include "../rendering/shaders/Phong.h"
 #include "../debuging/Logger.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #undef LoadImage
 
@@ -19,14 +25,66 @@ constexpr const char* ERROR_MODEL3D_PATH = "models/MeshError/MeshError.obj";
 
 constexpr const char* ASSETS_PATH_PREFIX = "../../assets/";
 
+constexpr std::size_t DEFAULT_CPU_BUDGET = 512 * 1024 * 1024;
+constexpr std::size_t DEFAULT_GPU_BUDGET = 1024 * 1024 * 1024;
+
 class ResourcesManager {
 public:
-    Image& LoadImage(std::string path);
-    const aiScene& LoadModel(const std::string& path);
+    using ImageHandle = std::shared_ptr<Image>;
+    using ModelHandle = std::shared_ptr<const aiScene>;
+    using TextureHandle = std::shared_ptr<rendering::Texture>;
+    using StaticModelHandle = std::shared_ptr<const rendering::Phong::StaticModel::Asset>;
+
+    ResourcesManager() = default;
+    ResourcesManager(const ResourcesManager&) = delete;
+    ResourcesManager& operator=(const ResourcesManager&) = delete;
+    ResourcesManager(ResourcesManager&&) = delete;
+    ResourcesManager& operator=(ResourcesManager&&) = delete;
+    ~ResourcesManager() = default;
+
+    ImageHandle LoadImage(const std::string& path);
+
+    // Images missing from the cache are decoded concurrently, handles keep order of paths
+    std::vector<ImageHandle> LoadImages(const std::vector<std::string>& paths);
+
+    ModelHandle LoadModel(const std::string& path);
+    TextureHandle LoadTexture(const std::string& path, rendering::Texture::EType type);
+    StaticModelHandle LoadStaticModel(const std::string& path, const rendering::Phong::StaticModel::ImportSettings& settings = {});
+
+    // Models imported by the caller are identified by scene, renderers of one scene share the asset while any of them is alive
+    StaticModelHandle LoadStaticModel(const aiScene& raw_model, const std::string& directory, const rendering::Phong::StaticModel::ImportSettings& settings = {});
+
+    // Budgets in bytes, 0 disables eviction
+    // Images and models share CPU budget, textures and static models share GPU budget
+    // Geometry counts as whole reserved pools, including static chunks and meshes not loaded through the manager
+    void CPUBudget(std::size_t budget);
+    std::size_t CPUBudget() const;
+    void GPUBudget(std::size_t budget);
+    std::size_t GPUBudget() const;
+
+    std::size_t CPUUsage() const;
+    std::size_t GPUUsage() const;
+
+    // Drop images and models from CPU memory as soon as they are uploaded to GPU
+    void ReleaseUploadedData(bool release) { m_ReleaseUploadedData = release; }
+    bool ReleaseUploadedData() const { return m_ReleaseUploadedData; }
+
+    // Evict unreferenced resources exceeding budgets
+    void Trim();
+
+    // Evict every unreferenced resource
+    void Purge();
 
 private:
-    std::unordered_map<std::string, Image> m_Textures;
-    std::unordered_map<std::string, Assimp::Importer> m_Models2;
+    ResourceCache<Image> m_Images{ DEFAULT_CPU_BUDGET };
+    ResourceCache<const aiScene> m_Models{ DEFAULT_CPU_BUDGET };
+    ResourceCache<rendering::Texture> m_Textures{ DEFAULT_GPU_BUDGET };
+    ResourceCache<const rendering::Phong::StaticModel::Asset> m_StaticModels{ DEFAULT_GPU_BUDGET };
+    std::unordered_map<std::string, std::weak_ptr<const rendering::Phong::StaticModel::Asset>> m_SceneStaticModels;
+    bool m_ReleaseUploadedData{ false };
+
+    void TrimCPU();
+    void TrimGPU();
 };
 
 }
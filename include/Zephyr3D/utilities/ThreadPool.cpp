@@ -0,0 +1,71 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+zephyr::ThreadPool::ThreadPool() {
+    const unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    m_Threads.reserve(threads);
+    for (unsigned int i = 0; i < threads; i++) {
+        m_Threads.emplace_back(&ThreadPool::m_Work, this);
+    }
+}
+
+zephyr::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_all();
+
+    for (auto& thread : m_Threads) {
+        thread.join();
+    }
+}
+
+void zephyr::ThreadPool::Run(std::size_t count, const std::function<void(std::size_t)>& task) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (m_Task != nullptr || m_Threads.empty() || count <= 1) {
+        lock.unlock();
+        for (std::size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    m_Task = &task;
+    m_Count = count;
+    m_Next = 0;
+    m_Pending = count;
+    m_Wake.notify_all();
+
+    m_Execute(lock);
+    m_Done.wait(lock, [this]() { return m_Pending == 0; });
+    m_Task = nullptr;
+}
+
+void zephyr::ThreadPool::m_Work() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true) {
+        m_Wake.wait(lock, [this]() { return m_Stop || (m_Task != nullptr && m_Next < m_Count); });
+        if (m_Stop) {
+            return;
+        }
+
+        m_Execute(lock);
+    }
+}
+
+void zephyr::ThreadPool::m_Execute(std::unique_lock<std::mutex>& lock) {
+    while (m_Task != nullptr && m_Next < m_Count) {
+        const auto& task = *m_Task;
+        const std::size_t index = m_Next++;
+
+        lock.unlock();
+        task(index);
+        lock.lock();
+
+        if (--m_Pending == 0) {
+            m_Done.notify_all();
+        }
+    }
+}
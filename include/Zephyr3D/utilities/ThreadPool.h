@@ -0,0 +1,54 @@
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zephyr {
+
+// Worker threads started once and reused for per frame parallel work
+// Run blocks until every task index was processed, calling thread takes tasks as well.
+// Run issued while another one is in progress, e.g. from inside a task, executes serially.
+class ThreadPool {
+public:
+    static ThreadPool& Instance() {
+        static ThreadPool instance;
+        return instance;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // Threads taking part in Run, including the calling one
+    std::size_t Workers() const { return m_Threads.size() + 1; }
+
+    void Run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+    ThreadPool();
+    ~ThreadPool();
+
+    void m_Work();
+    void m_Execute(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> m_Threads;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Done;
+
+    const std::function<void(std::size_t)>* m_Task{ nullptr };
+    std::size_t m_Count{ 0 };
+    std::size_t m_Next{ 0 };
+    std::size_t m_Pending{ 0 };
+    bool m_Stop{ false };
+};
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include "Test.h"
+
+#include <Zephyr3D/rendering/culling/AABBTree.h>
+
+#pragma warning(push, 0)
+#include <glm/gtc/matrix_transform.hpp>
+#pragma warning(pop)
+
+#include <random>
+#include <set>
+#include <vector>
+
+using zephyr::rendering::AABB;
+using zephyr::rendering::AABBTree;
+using zephyr::rendering::Frustum;
+
+namespace {
+
+struct Proxy {
+    AABB Box;
+    int Handle{ AABBTree::NULL_NODE };
+};
+
+AABB RandomBox(std::mt19937& random, float range, float max_extent) {
+    std::uniform_real_distribution<float> position(-range, range);
+    std::uniform_real_distribution<float> extent(0.1f, max_extent);
+
+    const glm::vec3 center(position(random), position(random), position(random));
+    const glm::vec3 extents(extent(random), extent(random), extent(random));
+    return AABB{ center - extents, center + extents };
+}
+
+std::vector<Proxy> Populate(AABBTree& tree, std::mt19937& random, std::size_t count) {
+    std::vector<Proxy> proxies(count);
+    for (auto& proxy : proxies) {
+        proxy.Box = RandomBox(random, 100.0f, 5.0f);
+        proxy.Handle = tree.Insert(proxy.Box, &proxy);
+    }
+
+    return proxies;
+}
+
+// Leaves are tested with their fattened bounds, brute force has to do the same
+std::set<const Proxy*> BruteForce(const AABBTree& tree, const std::vector<Proxy>& proxies, const AABB& box) {
+    std::set<const Proxy*> result;
+    for (const auto& proxy : proxies) {
+        if (proxy.Handle != AABBTree::NULL_NODE && tree.FatBounds(proxy.Handle).Overlaps(box)) {
+            result.insert(&proxy);
+        }
+    }
+
+    return result;
+}
+
+std::set<const Proxy*> BruteForce(const AABBTree& tree, const std::vector<Proxy>& proxies, const Frustum& frustum) {
+    std::set<const Proxy*> result;
+    for (const auto& proxy : proxies) {
+        if (proxy.Handle != AABBTree::NULL_NODE && frustum.Visible(tree.FatBounds(proxy.Handle))) {
+            result.insert(&proxy);
+        }
+    }
+
+    return result;
+}
+
+template <class Volume>
+std::set<const Proxy*> Query(const AABBTree& tree, const Volume& volume) {
+    std::set<const Proxy*> result;
+    tree.Query(volume, [&result](void* user_data) {
+        result.insert(static_cast<const Proxy*>(user_data));
+    });
+
+    return result;
+}
+
+bool MatchesBruteForce(const AABBTree& tree, const std::vector<Proxy>& proxies, std::mt19937& random) {
+    for (int i = 0; i < 50; i++) {
+        const AABB box = RandomBox(random, 100.0f, 30.0f);
+        if (Query(tree, box) != BruteForce(tree, proxies, box)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+TEST(AABBTreeInsert) {
+    std::mt19937 random(1);
+    AABBTree tree;
+    const auto proxies = Populate(tree, random, 500);
+
+    CHECK(tree.Count() == proxies.size());
+    CHECK(tree.Height() <= 20);
+
+    for (const auto& proxy : proxies) {
+        CHECK(tree.UserData(proxy.Handle) == &proxy);
+        CHECK(tree.FatBounds(proxy.Handle).Contains(proxy.Box));
+    }
+
+    CHECK(MatchesBruteForce(tree, proxies, random));
+}
+
+TEST(AABBTreeQueryReturnsEveryOverlap) {
+    std::mt19937 random(2);
+    AABBTree tree;
+    const auto proxies = Populate(tree, random, 500);
+
+    for (int i = 0; i < 50; i++) {
+        const AABB box = RandomBox(random, 100.0f, 30.0f);
+        const auto result = Query(tree, box);
+
+        for (const auto& proxy : proxies) {
+            if (proxy.Box.Overlaps(box)) {
+                CHECK(result.count(&proxy) == 1);
+            }
+        }
+    }
+}
+
+TEST(AABBTreeMove) {
+    std::mt19937 random(3);
+    AABBTree tree(0.5f);
+    auto proxies = Populate(tree, random, 500);
+
+    std::uniform_real_distribution<float> nudge(-0.1f, 0.1f);
+    for (auto& proxy : proxies) {
+        // Movement within the margin keeps the leaf in place
+        const glm::vec3 offset(nudge(random), nudge(random), nudge(random));
+        proxy.Box = AABB{ proxy.Box.Min + offset, proxy.Box.Max + offset };
+        CHECK(!tree.Move(proxy.Handle, proxy.Box));
+    }
+
+    for (std::size_t i = 0; i < proxies.size(); i += 2) {
+        proxies[i].Box = RandomBox(random, 100.0f, 5.0f);
+        tree.Move(proxies[i].Handle, proxies[i].Box);
+    }
+
+    for (const auto& proxy : proxies) {
+        CHECK(tree.FatBounds(proxy.Handle).Contains(proxy.Box));
+    }
+
+    CHECK(tree.Count() == proxies.size());
+    CHECK(MatchesBruteForce(tree, proxies, random));
+}
+
+TEST(AABBTreeRemove) {
+    std::mt19937 random(4);
+    AABBTree tree;
+    auto proxies = Populate(tree, random, 500);
+
+    for (std::size_t i = 0; i < proxies.size(); i += 3) {
+        tree.Remove(proxies[i].Handle);
+        proxies[i].Handle = AABBTree::NULL_NODE;
+    }
+
+    CHECK(tree.Count() == proxies.size() - (proxies.size() + 2) / 3);
+    CHECK(MatchesBruteForce(tree, proxies, random));
+
+    // Removed proxies come back with new boxes into freed nodes
+    for (auto& proxy : proxies) {
+        if (proxy.Handle == AABBTree::NULL_NODE) {
+            proxy.Box = RandomBox(random, 100.0f, 5.0f);
+            proxy.Handle = tree.Insert(proxy.Box, &proxy);
+        }
+    }
+
+    CHECK(tree.Count() == proxies.size());
+    CHECK(MatchesBruteForce(tree, proxies, random));
+}
+
+TEST(AABBTreeFrustumQuery) {
+    std::mt19937 random(5);
+    AABBTree tree;
+    const auto proxies = Populate(tree, random, 500);
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 80.0f);
+    const glm::vec3 eyes[] = { glm::vec3(0.0f), glm::vec3(50.0f, 10.0f, -20.0f), glm::vec3(-120.0f, 0.0f, 0.0f) };
+    for (const auto& eye : eyes) {
+        const Frustum frustum(projection * glm::lookAt(eye, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        CHECK(Query(tree, frustum) == BruteForce(tree, proxies, frustum));
+    }
+
+    // Boxes fully outside are never reported
+    const Frustum frustum(projection * glm::lookAt(glm::vec3(0.0f, 500.0f, 0.0f), glm::vec3(0.0f, 1000.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    CHECK(Query(tree, frustum).empty());
+}
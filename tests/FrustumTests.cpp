@@ -0,0 +1,55 @@
+#include "Test.h"
+
+#include <Zephyr3D/rendering/culling/Frustum.h>
+
+#pragma warning(push, 0)
+#include <glm/gtc/matrix_transform.hpp>
+#pragma warning(pop)
+
+using zephyr::rendering::AABB;
+using zephyr::rendering::Frustum;
+
+namespace {
+
+// Camera at origin looking down -Z, 90 degrees field of view, depth range [1, 100]
+Frustum CameraFrustum() {
+    const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum(projection * view);
+}
+
+AABB Box(const glm::vec3& center, float extent) {
+    return AABB{ center - glm::vec3(extent), center + glm::vec3(extent) };
+}
+
+}
+
+TEST(FrustumAcceptsBoxInside) {
+    const Frustum frustum = CameraFrustum();
+
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f)) == Frustum::EResult::Inside);
+    CHECK(frustum.Test(Box(glm::vec3(5.0f, -5.0f, -50.0f), 1.0f)) == Frustum::EResult::Inside);
+}
+
+TEST(FrustumRejectsBoxOutside) {
+    const Frustum frustum = CameraFrustum();
+
+    // Behind camera, beyond far plane and past each side plane
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 0.0f, -150.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(frustum.Test(Box(glm::vec3(-30.0f, 0.0f, -10.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(frustum.Test(Box(glm::vec3(30.0f, 0.0f, -10.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, -30.0f, -10.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 30.0f, -10.0f), 1.0f)) == Frustum::EResult::Outside);
+    CHECK(!frustum.Visible(Box(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f)));
+}
+
+TEST(FrustumReportsIntersectingBox) {
+    const Frustum frustum = CameraFrustum();
+
+    // Crossing near, far and left planes
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 0.0f, -1.0f), 0.5f)) == Frustum::EResult::Intersects);
+    CHECK(frustum.Test(Box(glm::vec3(0.0f, 0.0f, -100.0f), 2.0f)) == Frustum::EResult::Intersects);
+    CHECK(frustum.Test(Box(glm::vec3(-10.0f, 0.0f, -10.0f), 1.0f)) == Frustum::EResult::Intersects);
+    CHECK(frustum.Visible(Box(glm::vec3(-10.0f, 0.0f, -10.0f), 1.0f)));
+}
@@ -0,0 +1,156 @@
+#include "Test.h"
+
+#include <Zephyr3D/rendering/NullCommandBackend.h>
+#include <Zephyr3D/rendering/RenderQueue.h>
+#include <Zephyr3D/rendering/RenderStats.h>
+#include <Zephyr3D/rendering/ShaderProgram.h>
+
+#include <vector>
+
+using namespace zephyr::rendering;
+
+namespace {
+
+struct TestDrawable {
+    GLuint VAO;
+    GLsizei Count;
+};
+
+// Binds vertex array of the drawable when it differs from previous packet and draws it
+class TestShader : public ShaderProgram {
+public:
+    explicit TestShader(const std::string& name)
+        : ShaderProgram(name) {
+    }
+
+    void Draw(const ICamera* /*camera*/) override {}
+
+    void RecordPacket(const RenderPacket& packet, const RenderPacket* previous, CommandList& commands) const override {
+        const auto& drawable = *static_cast<const TestDrawable*>(packet.Drawable);
+        if (!previous || static_cast<const TestDrawable*>(previous->Drawable)->VAO != drawable.VAO) {
+            commands.BindVertexArray(drawable.VAO);
+        }
+
+        commands.DrawArrays(GL_TRIANGLES, 0, drawable.Count);
+    }
+};
+
+RenderPacket Packet(ERenderPass pass, TestShader& shader, GLuint shader_key, const TestDrawable& drawable, float depth) {
+    return RenderPacket{ RenderQueue::MakeKey(pass, shader_key, 0, drawable.VAO, depth), &shader, &drawable, nullptr, glm::mat4(1.0f) };
+}
+
+std::vector<Command> Replay(const RenderQueue& queue) {
+    std::vector<CommandList> lists;
+    queue.Record(lists);
+
+    NullCommandBackend backend;
+    for (const auto& list : lists) {
+        backend.Execute(list);
+    }
+
+    return backend.Commands();
+}
+
+}
+
+TEST(RenderQueueRecordsSortedPackets) {
+    TestShader first("First");
+    TestShader second("Second");
+
+    // Draw counts identify packets in the recorded stream
+    const TestDrawable near_a{ 10, 3 };
+    const TestDrawable far_a{ 10, 6 };
+    const TestDrawable other{ 20, 9 };
+    const TestDrawable transparent_near{ 10, 12 };
+    const TestDrawable transparent_far{ 10, 15 };
+
+    RenderQueue queue;
+    queue.Submit(Packet(ERenderPass::Transparent, first, 1, transparent_near, 2.0f));
+    queue.Submit(Packet(ERenderPass::Opaque, second, 2, other, 3.0f));
+    queue.Submit(Packet(ERenderPass::Opaque, first, 1, far_a, 5.0f));
+    queue.Submit(Packet(ERenderPass::Transparent, first, 1, transparent_far, 8.0f));
+    queue.Submit(Packet(ERenderPass::Opaque, first, 1, near_a, 1.0f));
+    queue.Sort();
+
+    RenderStats::Frame() = RenderStats();
+    const auto commands = Replay(queue);
+
+    // Opaque front to back grouped by shader, then transparent back to front
+    const std::vector<std::pair<ECommand, GLint>> expected = {
+        { ECommand::UseProgram, 0 },
+        { ECommand::BindVertexArray, 10 },
+        { ECommand::DrawArrays, 3 },
+        { ECommand::DrawArrays, 6 },
+        { ECommand::UseProgram, 0 },
+        { ECommand::BindVertexArray, 20 },
+        { ECommand::DrawArrays, 9 },
+        { ECommand::UseProgram, 0 },
+        { ECommand::BindVertexArray, 10 },
+        { ECommand::DrawArrays, 15 },
+        { ECommand::DrawArrays, 12 }
+    };
+
+    CHECK(commands.size() == expected.size());
+    for (std::size_t i = 0; i < std::min(commands.size(), expected.size()); i++) {
+        CHECK(commands[i].Type == expected[i].first);
+
+        switch (commands[i].Type) {
+        case ECommand::BindVertexArray:
+            CHECK(static_cast<GLint>(commands[i].Name) == expected[i].second);
+            break;
+
+        case ECommand::DrawArrays:
+            CHECK(commands[i].Target == GL_TRIANGLES);
+            CHECK(commands[i].Count == expected[i].second);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    CHECK(RenderStats::Frame().DrawCalls == 5);
+    CHECK(RenderStats::Frame().Triangles == (3 + 6 + 9 + 12 + 15) / 3);
+}
+
+TEST(RenderQueueListsStartFromUnknownState) {
+    TestShader shader("Shader");
+
+    std::vector<TestDrawable> drawables;
+    std::vector<RenderPacket> packets;
+    for (GLuint i = 0; i < 4 * RenderQueue::MIN_PACKETS_PER_LIST; i++) {
+        drawables.push_back({ i % 7, static_cast<GLsizei>(3 * (i + 1)) });
+    }
+
+    RenderQueue queue;
+    for (std::size_t i = 0; i < drawables.size(); i++) {
+        packets.push_back(Packet(ERenderPass::Opaque, shader, 1, drawables[i], static_cast<float>(drawables.size() - i)));
+        queue.Submit(packets.back());
+    }
+    queue.Sort();
+
+    std::vector<CommandList> lists;
+    queue.Record(lists);
+
+    std::size_t draws = 0;
+    std::uint64_t previous_key = 0;
+    for (const auto& list : lists) {
+        CHECK(!list.Empty());
+        CHECK(list.Commands().front().Type == ECommand::UseProgram);
+        CHECK(list.Size() > 1 && list.Commands()[1].Type == ECommand::BindVertexArray);
+
+        for (const auto& command : list.Commands()) {
+            if (command.Type != ECommand::DrawArrays) {
+                continue;
+            }
+
+            // Draw count identifies the packet, lists concatenated in order keep keys sorted
+            const std::uint64_t key = packets[command.Count / 3 - 1].Key;
+            CHECK(key >= previous_key);
+            previous_key = key;
+            draws++;
+        }
+    }
+
+    CHECK(draws == drawables.size());
+}
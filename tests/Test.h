@@ -0,0 +1,44 @@
+#ifndef Test_h
+#define Test_h
+
+#include <cstdio>
+#include <vector>
+
+namespace zephyr::tests {
+
+// Tests register themselves before main, failed checks are printed and counted
+struct Test {
+    const char* Name;
+    void (*Function)();
+
+    static std::vector<Test>& All() {
+        static std::vector<Test> tests;
+        return tests;
+    }
+
+    static int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+};
+
+struct Registration {
+    Registration(const char* name, void (*function)()) { Test::All().push_back(Test{ name, function }); }
+};
+
+}
+
+#define TEST(name) \
+    static void name(); \
+    static zephyr::tests::Registration name##_registration(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            zephyr::tests::Test::Failures()++; \
+        } \
+    } while (false)
+
+#endif
@@ -0,0 +1,11 @@
+#include "Test.h"
+
+int main() {
+    for (const auto& test : zephyr::tests::Test::All()) {
+        const int failures = zephyr::tests::Test::Failures();
+        test.Function();
+        std::printf("%s %s\n", zephyr::tests::Test::Failures() == failures ? "[ OK ]" : "[FAIL]", test.Name);
+    }
+
+    return zephyr::tests::Test::Failures() == 0 ? 0 : 1;
+}
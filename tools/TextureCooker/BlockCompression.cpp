@@ -0,0 +1,231 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+std::uint16_t To565(const float color[3]) {
+    const auto r = static_cast<std::uint16_t>(std::clamp(std::lround(color[0] * 31.0f / 255.0f), 0L, 31L));
+    const auto g = static_cast<std::uint16_t>(std::clamp(std::lround(color[1] * 63.0f / 255.0f), 0L, 63L));
+    const auto b = static_cast<std::uint16_t>(std::clamp(std::lround(color[2] * 31.0f / 255.0f), 0L, 31L));
+
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void From565(std::uint16_t color, int out[3]) {
+    const int r = (color >> 11) & 31;
+    const int g = (color >> 5) & 63;
+    const int b = color & 31;
+
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+}
+
+cooker::Surface cooker::Downsample(const Surface& surface) {
+    Surface result;
+    result.Width = std::max(surface.Width / 2, 1);
+    result.Height = std::max(surface.Height / 2, 1);
+    result.Pixels.resize(static_cast<std::size_t>(result.Width) * result.Height * 4);
+
+    // 2x2 box filter, edges are clamped for odd sizes
+    for (int y = 0; y < result.Height; y++) {
+        for (int x = 0; x < result.Width; x++) {
+            const int x0 = std::min(x * 2, surface.Width - 1);
+            const int x1 = std::min(x * 2 + 1, surface.Width - 1);
+            const int y0 = std::min(y * 2, surface.Height - 1);
+            const int y1 = std::min(y * 2 + 1, surface.Height - 1);
+
+            for (int c = 0; c < 4; c++) {
+                const int sum = surface.Pixels[(y0 * surface.Width + x0) * 4 + c]
+                    + surface.Pixels[(y0 * surface.Width + x1) * 4 + c]
+                    + surface.Pixels[(y1 * surface.Width + x0) * 4 + c]
+                    + surface.Pixels[(y1 * surface.Width + x1) * 4 + c];
+
+                result.Pixels[(y * result.Width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::uint8_t> cooker::Compress(const Surface& surface, EFormat format) {
+    const int blocks_x = (surface.Width + 3) / 4;
+    const int blocks_y = (surface.Height + 3) / 4;
+    const std::size_t block_size = format == EFormat::BC3 ? 16 : 8;
+
+    std::vector<std::uint8_t> result(static_cast<std::size_t>(blocks_x) * blocks_y * block_size);
+    std::uint8_t block[64];
+
+    for (int by = 0; by < blocks_y; by++) {
+        for (int bx = 0; bx < blocks_x; bx++) {
+            // Gather 4x4 block, pixels outside of the surface repeat the edge
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    const int sx = std::min(bx * 4 + x, surface.Width - 1);
+                    const int sy = std::min(by * 4 + y, surface.Height - 1);
+                    std::memcpy(&block[(y * 4 + x) * 4], &surface.Pixels[(sy * surface.Width + sx) * 4], 4);
+                }
+            }
+
+            std::uint8_t* out = &result[(by * blocks_x + bx) * block_size];
+            switch (format) {
+            case EFormat::BC1:
+                CompressBlockBC1(block, out);
+                break;
+
+            case EFormat::BC3:
+                CompressBlockBC4(block, 3, out);
+                CompressBlockBC1(block, out + 8);
+                break;
+
+            case EFormat::BC4:
+                CompressBlockBC4(block, 0, out);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+void cooker::CompressBlockBC1(const std::uint8_t rgba[64], std::uint8_t* out) {
+    // Principal axis of the block colors
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += rgba[i * 4 + c] / 16.0f;
+        }
+    }
+
+    float cov[6] = { 0.0f };
+    for (int i = 0; i < 16; i++) {
+        const float r = rgba[i * 4 + 0] - mean[0];
+        const float g = rgba[i * 4 + 1] - mean[1];
+        const float b = rgba[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; iteration++) {
+        const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        const float length = std::max({ std::abs(x), std::abs(y), std::abs(z) });
+        if (length <= 0.0f) {
+            break;
+        }
+
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    // Endpoints are the extreme projections on the axis
+    int min_index = 0, max_index = 0;
+    float min_dot = 0.0f, max_dot = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        const float dot = rgba[i * 4 + 0] * axis[0] + rgba[i * 4 + 1] * axis[1] + rgba[i * 4 + 2] * axis[2];
+        if (i == 0 || dot < min_dot) {
+            min_dot = dot;
+            min_index = i;
+        }
+        if (i == 0 || dot > max_dot) {
+            max_dot = dot;
+            max_index = i;
+        }
+    }
+
+    const float max_color[3] = { float(rgba[max_index * 4]), float(rgba[max_index * 4 + 1]), float(rgba[max_index * 4 + 2]) };
+    const float min_color[3] = { float(rgba[min_index * 4]), float(rgba[min_index * 4 + 1]), float(rgba[min_index * 4 + 2]) };
+    std::uint16_t color0 = To565(max_color);
+    std::uint16_t color1 = To565(min_color);
+
+    std::uint32_t indices = 0;
+    if (color0 != color1) {
+        // Four color mode requires color0 > color1
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        int palette[4][3];
+        From565(color0, palette[0]);
+        From565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int best_error = -1;
+            for (int p = 0; p < 4; p++) {
+                const int dr = rgba[i * 4 + 0] - palette[p][0];
+                const int dg = rgba[i * 4 + 1] - palette[p][1];
+                const int db = rgba[i * 4 + 2] - palette[p][2];
+                const int error = dr * dr + dg * dg + db * db;
+                if (best_error < 0 || error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+
+            indices |= static_cast<std::uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<std::uint8_t>(color0 & 0xFF);
+    out[1] = static_cast<std::uint8_t>(color0 >> 8);
+    out[2] = static_cast<std::uint8_t>(color1 & 0xFF);
+    out[3] = static_cast<std::uint8_t>(color1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        out[4 + i] = static_cast<std::uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
+
+void cooker::CompressBlockBC4(const std::uint8_t rgba[64], int channel, std::uint8_t* out) {
+    int max_value = 0, min_value = 255;
+    for (int i = 0; i < 16; i++) {
+        max_value = std::max<int>(max_value, rgba[i * 4 + channel]);
+        min_value = std::min<int>(min_value, rgba[i * 4 + channel]);
+    }
+
+    std::uint64_t indices = 0;
+    if (max_value != min_value) {
+        // Eight value mode, value0 > value1
+        int palette[8];
+        palette[0] = max_value;
+        palette[1] = min_value;
+        for (int p = 1; p < 7; p++) {
+            palette[p + 1] = ((7 - p) * max_value + p * min_value) / 7;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            const int value = rgba[i * 4 + channel];
+
+            int best = 0;
+            int best_error = 256;
+            for (int p = 0; p < 8; p++) {
+                const int error = std::abs(value - palette[p]);
+                if (error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+
+            indices |= static_cast<std::uint64_t>(best) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<std::uint8_t>(max_value);
+    out[1] = static_cast<std::uint8_t>(min_value);
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<std::uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef BlockCompression_h
+#define BlockCompression_h
+
+#include <cstdint>
+#include <vector>
+
+namespace cooker {
+
+// Single mip level of RGBA8 pixels
+struct Surface {
+    int Width;
+    int Height;
+    std::vector<std::uint8_t> Pixels;
+};
+
+enum class EFormat {
+    BC1,    // RGB, 8 bytes per block
+    BC3,    // RGBA, 16 bytes per block
+    BC4     // R, 8 bytes per block
+};
+
+Surface Downsample(const Surface& surface);
+std::vector<std::uint8_t> Compress(const Surface& surface, EFormat format);
+
+void CompressBlockBC1(const std::uint8_t rgba[64], std::uint8_t* out);
+void CompressBlockBC4(const std::uint8_t rgba[64], int channel, std::uint8_t* out);
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "BlockCompression.h"
+
+#include <Zephyr3D/resources/DDS.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Converts images found in assets directory into block compressed DDS files
+// with full mip chain, placed next to the source image. resources::Image picks
+// them up instead of decoding the source.
+//
+// Usage: Zephyr3D-texturecooker [assets directory] [--force]
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* DEFAULT_ASSETS_PATH = "../../assets/";
+
+bool IsSourceImage(const fs::path& path) {
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+bool Cook(const fs::path& source, const fs::path& destination) {
+    int width, height, components;
+    stbi_uc* data = stbi_load(source.string().c_str(), &width, &height, &components, 4);
+    if (!data) {
+        std::cout << "Failed to load " << source << ": " << stbi_failure_reason() << '\n';
+        return false;
+    }
+
+    cooker::Surface surface{ width, height, std::vector<std::uint8_t>(data, data + static_cast<std::size_t>(width) * height * 4) };
+    stbi_image_free(data);
+
+    // Fully opaque images don't need alpha block
+    bool has_alpha = false;
+    if (components == 2 || components == 4) {
+        for (std::size_t i = 3; i < surface.Pixels.size(); i += 4) {
+            if (surface.Pixels[i] != 255) {
+                has_alpha = true;
+                break;
+            }
+        }
+    }
+
+    const cooker::EFormat format = components == 1 ? cooker::EFormat::BC4 : has_alpha ? cooker::EFormat::BC3 : cooker::EFormat::BC1;
+
+    std::vector<std::vector<std::uint8_t>> levels;
+    levels.push_back(cooker::Compress(surface, format));
+    while (surface.Width > 1 || surface.Height > 1) {
+        surface = cooker::Downsample(surface);
+        levels.push_back(cooker::Compress(surface, format));
+    }
+
+    namespace dds = zephyr::resources::dds;
+
+    dds::Header header{};
+    header.Size = sizeof(dds::Header);
+    header.Flags = dds::DDSD_CAPS | dds::DDSD_HEIGHT | dds::DDSD_WIDTH | dds::DDSD_PIXELFORMAT | dds::DDSD_MIPMAPCOUNT | dds::DDSD_LINEARSIZE;
+    header.Height = static_cast<std::uint32_t>(height);
+    header.Width = static_cast<std::uint32_t>(width);
+    header.PitchOrLinearSize = static_cast<std::uint32_t>(levels.front().size());
+    header.MipMapCount = static_cast<std::uint32_t>(levels.size());
+    header.Format.Size = sizeof(dds::PixelFormat);
+    header.Format.Flags = dds::DDPF_FOURCC;
+    header.Format.FourCC = format == cooker::EFormat::BC1 ? dds::FOURCC_DXT1 : format == cooker::EFormat::BC3 ? dds::FOURCC_DXT5 : dds::FOURCC_ATI1;
+    header.Caps = dds::DDSCAPS_TEXTURE | dds::DDSCAPS_MIPMAP | dds::DDSCAPS_COMPLEX;
+
+    std::ofstream file(destination, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&dds::MAGIC), sizeof(dds::MAGIC));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& level : levels) {
+        file.write(reinterpret_cast<const char*>(level.data()), level.size());
+    }
+
+    if (!file) {
+        std::cout << "Failed to write " << destination << '\n';
+        return false;
+    }
+
+    const char* format_name = format == cooker::EFormat::BC1 ? "BC1" : format == cooker::EFormat::BC3 ? "BC3" : "BC4";
+    std::cout << source << " -> " << destination << " (" << format_name << ", " << width << "x" << height << ", " << levels.size() << " levels)\n";
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    fs::path assets_path = DEFAULT_ASSETS_PATH;
+    bool force = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--force") {
+            force = true;
+        } else {
+            assets_path = argument;
+        }
+    }
+
+    if (!fs::is_directory(assets_path)) {
+        std::cout << "Assets directory " << assets_path << " doesn't exist\n";
+        return EXIT_FAILURE;
+    }
+
+    int cooked = 0, skipped = 0, failed = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(assets_path)) {
+        if (!entry.is_regular_file() || !IsSourceImage(entry.path())) {
+            continue;
+        }
+
+        fs::path destination = entry.path();
+        destination.replace_extension(".dds");
+
+        // Skip up to date images
+        if (!force && fs::exists(destination) && fs::last_write_time(destination) >= fs::last_write_time(entry.path())) {
+            skipped++;
+            continue;
+        }
+
+        if (Cook(entry.path(), destination)) {
+            cooked++;
+        } else {
+            failed++;
+        }
+    }
+
+    std::cout << "Cooked " << cooked << ", up to date " << skipped << ", failed " << failed << '\n';
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}